@@ -0,0 +1,273 @@
+#include "main_widget.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <cmath>
+#include <cstdio>
+
+#define BENCH_WIDTH 1280 ///< Width of widget, pixels
+#define BENCH_HEIGHT 800 ///< Height of widget, pixels
+#define BENCH_FRAMES 64 ///< Default number of measured frames of each case
+#define BENCH_COORD_POINTS 1024 ///< Number of points converted from widget to GL in one measurement
+
+///
+/// \brief The OpenGLWidgetProbe class - runs internal steps of frame of OpenGLWidget
+///
+template<typename type, TYPE_VISIBLE T>
+class OpenGLWidgetProbe
+{
+public:
+
+    // --- Main methods ---
+
+    ///
+    /// \brief settle - wait for background builds of widget and apply their results
+    /// \param widget - measured widget
+    ///
+    static void settle(OpenGLWidget<type, T> &widget)
+    {
+        // Each pass may submit next one (extents, levels of detail, refinement)
+        for (int i = 0; i < 4; ++i) {
+            widget.m_taskGroup.wait();
+            QCoreApplication::processEvents();
+        }
+    }
+
+    ///
+    /// \brief resetScene - fit scene to graphs, measured by widget
+    /// \param widget - measured widget
+    ///
+    static void resetScene(OpenGLWidget<type, T> &widget)
+    {
+        widget.resetScene();
+    }
+
+    ///
+    /// \brief updateGrid - rebuild full grid, its signal makes MainWidget::updateGridValues rebuild labels, both are
+    /// measured by widgets
+    /// \param widget - measured widget
+    ///
+    static void updateGrid(OpenGLWidget<type, T> &widget)
+    {
+        widget.updateGrid(true);
+    }
+
+    ///
+    /// \brief coordWDtoGL - convert points along diagonal of widget
+    /// \param widget - measured widget
+    /// \return - duration in milliseconds
+    ///
+    static double coordWDtoGL(OpenGLWidget<type, T> &widget)
+    {
+        // Result is stored, so conversions aren't optimized out
+        static volatile double sink;
+        double sum{0};
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < BENCH_COORD_POINTS; ++i) {
+            QPointF point = widget.coordWDtoGL({i * BENCH_WIDTH / BENCH_COORD_POINTS, i * BENCH_HEIGHT / BENCH_COORD_POINTS});
+            sum += point.x() + point.y();
+        }
+        double ms = timer.nsecsElapsed() / 1e6;
+        sink = sum;
+
+        return ms;
+    }
+};
+
+///
+/// \brief The MainWidgetProbe class - runs internal steps of frame of MainWidget
+///
+template<typename type, TYPE_VISIBLE T>
+class MainWidgetProbe
+{
+public:
+
+    // --- Main methods ---
+
+    ///
+    /// \brief openGLWidget - get widget of tab
+    /// \param widget - measured widget
+    /// \param idTab - id of tab
+    /// \return - widget of tab
+    ///
+    static OpenGLWidget<type, T> &openGLWidget(MainWidget<type, T> &widget, int idTab)
+    {
+        return *widget.m_tabs[idTab].OGLWidget;
+    }
+};
+
+///
+/// \brief phaseJson - count statistics of measurements in the same form as FrameStatistics::toJson
+/// \param samples - durations in milliseconds
+/// \return - object {"p50", "p95", "max", "count"}
+///
+static QJsonObject phaseJson(std::vector<double> samples)
+{
+    QJsonObject result;
+    std::sort(samples.begin(), samples.end());
+    size_t count = samples.size();
+    result["p50"] = count ? samples[(count - 1) / 2] : 0;
+    result["p95"] = count ? samples[(count - 1) * 95 / 100] : 0;
+    result["max"] = count ? samples[count - 1] : 0;
+    result["count"] = static_cast<qint64>(count);
+
+    return result;
+}
+
+///
+/// \brief makeGraph - sine with noise, fits range of type
+/// \param samples - number of samples
+/// \return - graph values
+///
+template<typename type>
+static std::vector<type> makeGraph(size_t samples)
+{
+    std::vector<type> graph(samples);
+    unsigned int seed{1};
+    for (size_t i = 0; i < samples; ++i) {
+        seed = seed * 1103515245 + 12345;
+        double noise = static_cast<double>((seed >> 16) & 0x7FFF) / 0x7FFF - 0.5;
+        graph[i] = static_cast<type>(1000 * std::sin(i * 1e-3) + 100 * noise);
+    }
+
+    return graph;
+}
+
+///
+/// \brief runCase - measure frame pipeline for graph in mode
+/// \param graph - graph values
+/// \param mode - mode of graph
+/// \param frames - number of measured frames
+/// \return - object with statistics of widget and of conversions
+///
+template<typename type, TYPE_VISIBLE T>
+static QJsonObject runCase(std::vector<type> &graph, typename OpenGLWidget<type, T>::GRAPH_MODE mode, int frames)
+{
+    using OGLWProbe = OpenGLWidgetProbe<type, T>;
+    using MainProbe = MainWidgetProbe<type, T>;
+
+    MainWidget<type, T> widget;
+    widget.resize(BENCH_WIDTH, BENCH_HEIGHT);
+    int idTab = widget.addTab("Bench");
+    widget.setGraphMode(mode);
+    widget.addGraph(idTab, graph);
+    widget.show();
+
+    OpenGLWidget<type, T> &openGLWidget = MainProbe::openGLWidget(widget, idTab);
+    OGLWProbe::settle(openGLWidget);
+
+    // First frame initializes GL and uploads buffers, it isn't measured
+    openGLWidget.grabFramebuffer();
+    openGLWidget.getFrameTiming().clear();
+
+    std::vector<double> coordinates;
+    for (int i = 0; i < frames; ++i) {
+        OGLWProbe::resetScene(openGLWidget);
+        OGLWProbe::updateGrid(openGLWidget);
+        coordinates.push_back(OGLWProbe::coordWDtoGL(openGLWidget));
+        openGLWidget.grabFramebuffer();
+    }
+
+    QJsonObject result;
+    result["statistics"] = widget.getFrameStatistics(idTab).toJson();
+    result["coordWDtoGL"] = phaseJson(coordinates);
+    result["coordPoints"] = BENCH_COORD_POINTS;
+
+    return result;
+}
+
+///
+/// \brief runType - measure all modes and sizes of graph for visible type
+/// \param typeName - name of visible type
+/// \param sizes - numbers of samples
+/// \param frames - number of measured frames
+/// \param results - where objects of cases are added
+///
+template<typename type, TYPE_VISIBLE T>
+static void runType(const QString &typeName, const std::vector<size_t> &sizes, int frames, QJsonArray &results)
+{
+    using GRAPH_MODE = typename OpenGLWidget<type, T>::GRAPH_MODE;
+    const std::vector<std::pair<GRAPH_MODE, QString>> modes = {
+        {GRAPH_MODE::LINE, "LINE"},
+        {GRAPH_MODE::COLUMN, "COLUMN"},
+        {GRAPH_MODE::RECTANGLE, "RECTANGLE"},
+        {GRAPH_MODE::SCATTER, "SCATTER"}
+    };
+
+    for (size_t samples : sizes) {
+        std::vector<type> graph = makeGraph<type>(samples);
+        for (const auto &mode : modes) {
+            std::fprintf(stderr, "%s %s %zu\n", qPrintable(typeName), qPrintable(mode.second), samples);
+
+            QJsonObject result = runCase<type, T>(graph, mode.first, frames);
+            result["type"] = typeName;
+            result["mode"] = mode.second;
+            result["samples"] = static_cast<qint64>(samples);
+            result["frames"] = frames;
+            results.append(result);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Frames are rendered offscreen unless platform is chosen explicitly
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication application{argc, argv};
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmark of frame pipeline of 2D widget, statistics are printed in JSON");
+    parser.addHelpOption();
+    QCommandLineOption samplesOption{"samples", "Comma separated numbers of samples of graph.", "list",
+                                     "1000,10000,100000,1000000,10000000,100000000"};
+    QCommandLineOption framesOption{"frames", "Number of measured frames of each case.", "count",
+                                    QString::number(BENCH_FRAMES)};
+    QCommandLineOption typesOption{"types", "Comma separated visible types (SHORT,INT,FLOAT,DOUBLE).", "list",
+                                   "SHORT,INT,FLOAT,DOUBLE"};
+    QCommandLineOption outputOption{"output", "File of results, standard output by default.", "path"};
+    parser.addOptions({samplesOption, framesOption, typesOption, outputOption});
+    parser.process(application);
+
+    std::vector<size_t> sizes;
+    for (const QString &size : parser.value(samplesOption).split(',', Qt::SkipEmptyParts))
+        sizes.push_back(size.toULongLong());
+    int frames = std::max(parser.value(framesOption).toInt(), 1);
+    QStringList types = parser.value(typesOption).split(',', Qt::SkipEmptyParts);
+
+    QJsonArray results;
+    if (types.contains("SHORT"))
+        runType<short, TYPE_VISIBLE::SHORT>("SHORT", sizes, frames, results);
+    if (types.contains("INT"))
+        runType<int, TYPE_VISIBLE::INT>("INT", sizes, frames, results);
+    if (types.contains("FLOAT"))
+        runType<float, TYPE_VISIBLE::FLOAT>("FLOAT", sizes, frames, results);
+    if (types.contains("DOUBLE"))
+        runType<double, TYPE_VISIBLE::DOUBLE>("DOUBLE", sizes, frames, results);
+
+    QJsonObject report;
+    report["width"] = BENCH_WIDTH;
+    report["height"] = BENCH_HEIGHT;
+    report["results"] = results;
+    QByteArray json = QJsonDocument{report}.toJson();
+
+    if (parser.isSet(outputOption)) {
+        QFile file{parser.value(outputOption)};
+        if (!file.open(QIODevice::WriteOnly)) {
+            std::fprintf(stderr, "Can't write %s\n", qPrintable(file.fileName()));
+            return 1;
+        }
+        file.write(json);
+    } else {
+        std::fwrite(json.constData(), 1, json.size(), stdout);
+    }
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <QPoint>
+#include <QPointF>
+
+#include <cmath>
+#include <utility>
+
+#define CAMERA_PRECISE_PIXELS (1 << 20) ///< Distance from origin in pixels up to which float vertex is subpixel exact
+
+///
+/// \brief The Camera struct - view of scene: extents of scene, zoom and shift set by user and size of widget.
+/// Pixel density, pixel size and borders are derived in update, projection is applied by renderer at draw time
+///
+struct Camera {
+    std::pair<double, double>        zoom{1, 1}; ///< Current scene zoom factor X, Y = first, second
+    std::pair<double, double>      offset{0, 0}; ///< Current shift along axes X, Y = first, second
+
+    std::pair<int, int>              size{1, 1}; ///< Current widget size X, Y = first, second
+    std::pair<double, double>   sceneSize{1, 1}; ///< Scene size X, Y = first, second
+    std::pair<double, double>     minMaxX{0, 1}; ///< Minimum and maximum values of X
+    std::pair<double, double>     minMaxY{0, 1}; ///< Minimum and maximum values of Y
+
+    std::pair<double, double> pixelDensity{1, 1}; ///< Pixel density along axes X, Y = first, second
+    std::pair<double, double>   pixelSize{1, 1}; ///< Pixel sizes in scene measure
+    QPointF                           borderMax; ///< Max scene border, right upper corner
+    QPointF                           borderMin; ///< Max scene border, left lower corner
+    std::pair<double, double>    origin{0, 0}; ///< Point of scene from which vertices are given, center of view
+
+    // --- Main methods ---
+
+    ///
+    /// \brief update - recompute pixel density, pixel size and borders after change of scene or widget size
+    ///
+    void update()
+    {
+        pixelDensity.first = static_cast<double>(size.first) / sceneSize.first;
+        pixelDensity.second = static_cast<double>(size.second) / sceneSize.second;
+
+        pixelSize.first = sceneSize.first / size.first / zoom.first;
+        pixelSize.second = sceneSize.second / size.second / zoom.second;
+
+        // Scene is drawn half of widget beyond each edge, so short moves don't expose its border
+        borderMax = toGL(QPoint{size.first * 3 / 2, -size.second / 2});
+        borderMin = toGL(QPoint{-size.first / 2, size.second * 3 / 2});
+    }
+
+    ///
+    /// \brief updateOrigin - move origin to center of view, vertices near it are exact in float at any zoom
+    ///
+    void updateOrigin()
+    {
+        QPointF center = toGL(QPoint{size.first / 2, size.second / 2});
+        origin = {center.x(), center.y()};
+    }
+
+    ///
+    /// \brief transform - view transform for vertices relative to origin, projection is included, so only
+    /// terms in range of view are passed to OpenGL and large coordinates cancel out in double on CPU
+    /// \param translate - shift in normalized device coordinates
+    /// \param scale - scale from scene measure to normalized device coordinates
+    ///
+    void transform(std::pair<double, double> &translate, std::pair<double, double> &scale) const
+    {
+        double sizeX = minMaxX.second != minMaxX.first ? minMaxX.second - minMaxX.first : 1;
+        double sizeY = minMaxY.second != minMaxY.first ? minMaxY.second - minMaxY.first : 1;
+
+        scale.first = 2 * zoom.first / sizeX;
+        scale.second = 2 * zoom.second / sizeY;
+
+        translate.first = (2 * (offset.first + zoom.first * origin.first) - minMaxX.first - minMaxX.second) / sizeX;
+        translate.second = (2 * (offset.second + zoom.second * origin.second) - minMaxY.first - minMaxY.second) / sizeY;
+    }
+
+    ///
+    /// \brief isPrecise - whether vertex at distances from point of its transform is drawn exactly in float
+    /// \param distanceX - distance along X in scene measure
+    /// \param distanceY - distance along Y in scene measure
+    /// \return - true if error is under pixel on both axes
+    ///
+    bool isPrecise(double distanceX, double distanceY) const
+    {
+        return std::abs(distanceX) * pixelDensity.first * zoom.first < CAMERA_PRECISE_PIXELS
+                && std::abs(distanceY) * pixelDensity.second * zoom.second < CAMERA_PRECISE_PIXELS;
+    }
+
+    ///
+    /// \brief sameView - whether camera shows same part of scene in same widget size
+    /// \param other - other camera
+    /// \return - true if pixels of both cameras are same points of scene
+    ///
+    bool sameView(const Camera &other) const
+    {
+        return zoom == other.zoom && offset == other.offset && size == other.size && sceneSize == other.sceneSize
+                && minMaxX == other.minMaxX && minMaxY == other.minMaxY;
+    }
+
+    ///
+    /// \brief toGL - conversion coordinates from widget plane to GL
+    /// \param point - point in widget plane
+    /// \return - point in GL plane
+    ///
+    QPointF toGL(QPoint point) const
+    {
+        return {(point.x() / pixelDensity.first - offset.first) / zoom.first + minMaxX.first,
+                (minMaxY.second - point.y() / pixelDensity.second - offset.second) / zoom.second};
+    }
+
+    ///
+    /// \brief toWD - conversion coordinates from GL plane to widget
+    /// \param point - point in GL plane
+    /// \return - point in widget plane
+    ///
+    QPoint toWD(QPointF point) const
+    {
+        return QPoint(static_cast<int>((point.x() * zoom.first - minMaxX.first + offset.first) * pixelDensity.first),
+                      static_cast<int>(size.second - (point.y() * zoom.second - minMaxY.first + offset.second)
+                                       * pixelDensity.second));
+    }
+};
+
+#endif // CAMERA_H
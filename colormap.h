@@ -0,0 +1,120 @@
+#ifndef COLORMAP_H
+#define COLORMAP_H
+
+#include <QOpenGLTexture>
+#include <QImage>
+#include <QRgb>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#define COLORMAP_SIZE 256 ///< Number of colors in colormap texture
+
+///
+/// \brief The Colormap class - colors evenly spaced from lowest to highest level, uploaded in texture which is
+/// sampled by shaders. Texture is uploaded again when colors are changed
+///
+class Colormap
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    Colormap()
+    {
+        setColors({qRgba(0, 0, 64, 0), qRgb(0, 0, 160), qRgb(0, 160, 200), qRgb(60, 220, 60),
+                   qRgb(250, 220, 0), qRgb(255, 255, 255)});
+    }
+    ~Colormap() = default;
+
+    Colormap(const Colormap &) = delete;
+    Colormap &operator=(const Colormap &) = delete;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief bind - bind texture of colormap, context must be current
+    /// \param unit - texture unit
+    ///
+    void bind(uint unit)
+    {
+        if (m_changed || !m_texture) {
+            QImage image{COLORMAP_SIZE, 1, QImage::Format_ARGB32};
+            for (int i = 0; i < COLORMAP_SIZE; ++i)
+                image.setPixel(i, 0, color(static_cast<double>(i) / (COLORMAP_SIZE - 1)));
+            m_texture = std::make_unique<QOpenGLTexture>(image, QOpenGLTexture::DontGenerateMipMaps);
+            m_texture->setMinMagFilters(QOpenGLTexture::Linear, QOpenGLTexture::Linear);
+            m_texture->setWrapMode(QOpenGLTexture::ClampToEdge);
+            m_changed = false;
+        }
+
+        m_texture->bind(unit, QOpenGLTexture::ResetTextureUnit);
+    }
+
+    ///
+    /// \brief release - release texture of colormap
+    /// \param unit - texture unit
+    ///
+    void release(uint unit)
+    {
+        if (m_texture)
+            m_texture->release(unit, QOpenGLTexture::ResetTextureUnit);
+    }
+
+    ///
+    /// \brief destroy - release texture, context must be current
+    ///
+    void destroy()
+    {
+        m_texture.reset();
+    }
+
+    // --- Setters ---
+
+    ///
+    /// \brief setColors - set colors of colormap
+    /// \param colors - at least two colors, from lowest to highest level
+    ///
+    void setColors(const std::vector<QRgb> &colors)
+    {
+        if (colors.size() < 2)
+            return;
+
+        m_colors = colors;
+        m_changed = true;
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief color - color interpolated between colors of colormap
+    /// \param level - from 0 to 1
+    /// \return - color
+    ///
+    QRgb color(double level) const
+    {
+        double position = std::clamp(level, 0.0, 1.0) * (m_colors.size() - 1);
+        size_t index = std::min(static_cast<size_t>(position), m_colors.size() - 2);
+        double part = position - index;
+        QRgb a = m_colors[index], b = m_colors[index + 1];
+
+        auto mix = [part](int first, int second) {
+            return static_cast<int>(std::lround(first + (second - first) * part));
+        };
+
+        return qRgba(mix(qRed(a), qRed(b)), mix(qGreen(a), qGreen(b)), mix(qBlue(a), qBlue(b)),
+                     mix(qAlpha(a), qAlpha(b)));
+    }
+
+private:
+
+    // --- Fields ---
+
+    std::vector<QRgb>                   m_colors; ///< Colors of colormap
+    std::unique_ptr<QOpenGLTexture>    m_texture; ///< Colormap uploaded in texture
+    bool                          m_changed{true}; ///< Whether texture should be uploaded
+};
+
+#endif // COLORMAP_H
@@ -0,0 +1,240 @@
+#ifndef DENSITY_BUFFER_H
+#define DENSITY_BUFFER_H
+
+#include "colormap.h"
+
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QRgb>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#ifndef GL_RGBA32F
+#define GL_RGBA32F 0x8814
+#endif
+
+#define DENSITY_SATURATION 64 ///< Default number of hits of pixel shown by last color of colormap
+
+///
+/// \brief The DensityBuffer class - intensity rendering of graphs. Fragments of graphs add their coverage to float
+/// framebuffer, then hits of each pixel are mapped through colormap on logarithmic scale, as on phosphor screen of
+/// oscilloscope. Cost depends on pixels and segments, overlapping graphs don't hide each other
+///
+class DensityBuffer : protected QOpenGLFunctions
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    DensityBuffer() = default;
+    ~DensityBuffer() = default;
+
+    DensityBuffer(const DensityBuffer &) = delete;
+    DensityBuffer &operator=(const DensityBuffer &) = delete;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief begin - bind framebuffer of hits and set additive blending, context must be current
+    /// \param clear - whether to drop hits of previous frames, else they are faded by decay
+    /// \return - false if float framebuffer or shaders aren't supported, then graphs are drawn as usual
+    ///
+    bool begin(bool clear)
+    {
+        if (!init())
+            return false;
+
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        QSize size{std::max(viewport[2], 1), std::max(viewport[3], 1)};
+        if (!m_fbo || m_fbo->size() != size) {
+            QOpenGLFramebufferObjectFormat format;
+            format.setInternalTextureFormat(GL_RGBA32F);
+            m_fbo = std::make_unique<QOpenGLFramebufferObject>(size, format);
+            clear = true;
+        }
+        if (!m_fbo->isValid() || !m_fbo->bind()) {
+            m_fbo.reset();
+            m_supported = false;
+            return false;
+        }
+
+        glEnable(GL_BLEND);
+        if (clear || m_decay <= 0) {
+            glClearColor(0, 0, 0, 0);
+            glClear(GL_COLOR_BUFFER_BIT);
+        } else if (m_decay < 1) {
+            // Hits are multiplied by decay
+            glBlendFunc(GL_ZERO, GL_SRC_ALPHA);
+            glColor4f(0, 0, 0, static_cast<GLfloat>(m_decay));
+            fullScreenQuad();
+        }
+
+        // Each fragment adds its coverage, which is 1 without antialiasing
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        glColor4f(1, 1, 1, 1);
+
+        return true;
+    }
+
+    ///
+    /// \brief end - map hits through colormap to framebuffer of widget
+    /// \param target - framebuffer of widget
+    /// \param back - background color, clear color is restored to it
+    ///
+    void end(GLuint target, QRgb back)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+        glClearColor(qRed(back) / 255.0f, qGreen(back) / 255.0f, qBlue(back) / 255.0f, 1.0f);
+
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        m_colormap.bind(1);
+        glBindTexture(GL_TEXTURE_2D, m_fbo->texture());
+
+        m_program.bind();
+        m_program.setUniformValue("hits", 0);
+        m_program.setUniformValue("colormap", 1);
+        m_program.setUniformValue("scale", static_cast<GLfloat>(1 / std::log1p(m_saturation)));
+        fullScreenQuad();
+        m_program.release();
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+        m_colormap.release(1);
+        glDisable(GL_BLEND);
+    }
+
+    ///
+    /// \brief destroy - release GPU resources, context must be current
+    ///
+    void destroy()
+    {
+        m_fbo.reset();
+        m_colormap.destroy();
+        m_program.removeAllShaders();
+        m_initialized = false;
+    }
+
+    // --- Setters ---
+
+    ///
+    /// \brief setDecay - set part of hits kept from previous frame, e.g. for streaming data
+    /// \param decay - from 0 (each frame shows only its graphs) to 1 (hits are accumulated until view is changed)
+    ///
+    void setDecay(double decay)
+    {
+        m_decay = std::clamp(decay, 0.0, 1.0);
+    }
+
+    ///
+    /// \brief setSaturation - set number of hits shown by last color of colormap
+    /// \param hits - number of hits, at least 1
+    ///
+    void setSaturation(double hits)
+    {
+        m_saturation = std::max(hits, 1.0);
+    }
+
+    ///
+    /// \brief setColormap - set colors of colormap, evenly spaced from least to most hits
+    /// \param colors - at least two colors, alpha of first color is usually 0
+    ///
+    void setColormap(const std::vector<QRgb> &colors)
+    {
+        m_colormap.setColors(colors);
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief decay - part of hits kept from previous frame
+    /// \return - decay
+    ///
+    double decay() const
+    {
+        return m_decay;
+    }
+
+private:
+
+    // --- Helper methods ---
+
+    ///
+    /// \brief init - compile shader of colormap once
+    /// \return - false if it isn't supported
+    ///
+    bool init()
+    {
+        if (m_initialized)
+            return m_supported;
+
+        initializeOpenGLFunctions();
+        m_initialized = true;
+        m_supported = QOpenGLFramebufferObject::hasOpenGLFramebufferObjects()
+                && m_program.addShaderFromSourceCode(QOpenGLShader::Vertex,
+                                                     "varying vec2 position;\n"
+                                                     "void main() {\n"
+                                                     "    position = gl_MultiTexCoord0.xy;\n"
+                                                     "    gl_Position = gl_Vertex;\n"
+                                                     "}\n")
+                && m_program.addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                                     "uniform sampler2D hits;\n"
+                                                     "uniform sampler2D colormap;\n"
+                                                     "uniform float scale;\n"
+                                                     "varying vec2 position;\n"
+                                                     "void main() {\n"
+                                                     "    float count = texture2D(hits, position).r;\n"
+                                                     "    if (count <= 0.0)\n"
+                                                     "        discard;\n"
+                                                     "    float level = clamp(log(1.0 + count) * scale, 0.0, 1.0);\n"
+                                                     "    gl_FragColor = texture2D(colormap, vec2(level, 0.5));\n"
+                                                     "}\n")
+                && m_program.link();
+
+        return m_supported;
+    }
+
+    ///
+    /// \brief fullScreenQuad - draw quad covering viewport, matrices of scene are kept
+    ///
+    void fullScreenQuad()
+    {
+        glMatrixMode(GL_PROJECTION);
+        glPushMatrix();
+        glLoadIdentity();
+        glMatrixMode(GL_MODELVIEW);
+        glPushMatrix();
+        glLoadIdentity();
+
+        glBegin(GL_QUADS);
+        glTexCoord2f(0, 0);
+        glVertex2f(-1, -1);
+        glTexCoord2f(1, 0);
+        glVertex2f(1, -1);
+        glTexCoord2f(1, 1);
+        glVertex2f(1, 1);
+        glTexCoord2f(0, 1);
+        glVertex2f(-1, 1);
+        glEnd();
+
+        glPopMatrix();
+        glMatrixMode(GL_PROJECTION);
+        glPopMatrix();
+        glMatrixMode(GL_MODELVIEW);
+    }
+
+    // --- Fields ---
+
+    std::unique_ptr<QOpenGLFramebufferObject>      m_fbo; ///< Float framebuffer of hits
+    QOpenGLShaderProgram                        m_program; ///< Maps hits through colormap
+    Colormap                                   m_colormap; ///< Colors of hits
+    bool                              m_initialized{false}; ///< Whether shader is compiled
+    bool                                m_supported{false}; ///< Whether intensity rendering is supported
+    double                                    m_decay{0}; ///< Part of hits kept from previous frame
+    double                m_saturation{DENSITY_SATURATION}; ///< Number of hits shown by last color
+};
+
+#endif // DENSITY_BUFFER_H
@@ -0,0 +1,148 @@
+#ifndef DERIVED_SERIES_H
+#define DERIVED_SERIES_H
+
+#include <algorithm>
+#include <vector>
+
+///
+/// \brief The DERIVED_TRANSFORM enum - transforms by which derived series is computed from its source
+///
+enum class DERIVED_TRANSFORM : int {
+    MOVING_AVERAGE, ///< Mean of trailing window, parameter is number of samples of window
+    EXPONENTIAL,    ///< Exponential smoothing, parameter is weight of new sample from 0 to 1
+    DIFFERENCE,     ///< Difference of neighbour samples divided by parameter, first sample is 0
+    SCALE,          ///< Sample multiplied by parameter plus offset
+    RESAMPLE        ///< Mean of each block of samples, parameter is number of samples of block
+};
+
+///
+/// \brief The DerivedSeries class - series computed from source series. When source is changed from some sample,
+/// only outputs which depend on changed samples are recomputed, appended samples cost as much as their number
+///
+template<typename type>
+class DerivedSeries
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    ///
+    /// \brief DerivedSeries - create empty series
+    /// \param transform - transform of source
+    /// \param parameter - parameter of transform
+    /// \param offset - offset of scale transform
+    ///
+    DerivedSeries(DERIVED_TRANSFORM transform, double parameter, double offset = 0)
+        : m_transform{transform}, m_parameter{parameter}, m_offset{offset}
+    {
+        // Window and block are whole numbers of samples
+        if (m_transform == DERIVED_TRANSFORM::MOVING_AVERAGE || m_transform == DERIVED_TRANSFORM::RESAMPLE)
+            m_parameter = std::max(1.0, static_cast<double>(static_cast<size_t>(m_parameter)));
+        if (m_transform == DERIVED_TRANSFORM::EXPONENTIAL)
+            m_parameter = std::clamp(m_parameter, 0.0, 1.0);
+        if (m_transform == DERIVED_TRANSFORM::DIFFERENCE && m_parameter == 0)
+            m_parameter = 1;
+    }
+    ~DerivedSeries() = default;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief update - recompute outputs after change of source
+    /// \param input - samples of source
+    /// \param size - number of samples of source
+    /// \param from - first changed sample of source, samples before it are same as in previous update
+    /// \return - first changed output, outputs before it are same
+    ///
+    size_t update(const type *input, size_t size, size_t from)
+    {
+        from = std::min(from, size);
+
+        if (m_transform == DERIVED_TRANSFORM::RESAMPLE) {
+            size_t block = static_cast<size_t>(m_parameter);
+            size_t first = from / block;
+            m_output.resize((size + block - 1) / block);
+            for (size_t i = first; i < m_output.size(); ++i) {
+                size_t end = std::min(size, (i + 1) * block);
+                double sum{};
+                for (size_t j = i * block; j < end; ++j)
+                    sum += input[j];
+                m_output[i] = static_cast<type>(sum / (end - i * block));
+            }
+
+            return first;
+        }
+
+        m_output.resize(size);
+        switch (m_transform) {
+        case DERIVED_TRANSFORM::MOVING_AVERAGE: {
+            // Sum of window before first changed sample, then window slides
+            size_t window = static_cast<size_t>(m_parameter);
+            double sum{};
+            for (size_t j = from > window ? from - window : 0; j < from; ++j)
+                sum += input[j];
+            for (size_t i = from; i < size; ++i) {
+                sum += input[i];
+                if (i >= window)
+                    sum -= input[i - window];
+                m_output[i] = static_cast<type>(sum / std::min(i + 1, window));
+            }
+            break;
+        }
+        case DERIVED_TRANSFORM::EXPONENTIAL: {
+            // State is kept in double, so rounding of integer outputs doesn't accumulate
+            m_state.resize(size);
+            for (size_t i = from; i < size; ++i) {
+                m_state[i] = i == 0 ? input[0] : m_parameter * input[i] + (1 - m_parameter) * m_state[i - 1];
+                m_output[i] = static_cast<type>(m_state[i]);
+            }
+            break;
+        }
+        case DERIVED_TRANSFORM::DIFFERENCE:
+            for (size_t i = from; i < size; ++i)
+                m_output[i] = i == 0 ? type{} : static_cast<type>((static_cast<double>(input[i]) - input[i - 1])
+                                                                 / m_parameter);
+            break;
+        case DERIVED_TRANSFORM::SCALE:
+            for (size_t i = from; i < size; ++i)
+                m_output[i] = static_cast<type>(input[i] * m_parameter + m_offset);
+            break;
+        default:
+            break;
+        }
+
+        return from;
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief output - computed series
+    /// \return - samples of series
+    ///
+    const std::vector<type> &output() const
+    {
+        return m_output;
+    }
+
+    ///
+    /// \brief stride - number of source samples per output sample
+    /// \return - block of resample, else 1
+    ///
+    size_t stride() const
+    {
+        return m_transform == DERIVED_TRANSFORM::RESAMPLE ? static_cast<size_t>(m_parameter) : 1;
+    }
+
+private:
+
+    // --- Fields ---
+
+    DERIVED_TRANSFORM       m_transform; ///< Transform of source
+    double                  m_parameter; ///< Parameter of transform
+    double                     m_offset; ///< Offset of scale transform
+    std::vector<type>          m_output; ///< Computed series
+    std::vector<double>         m_state; ///< State of exponential smoothing
+};
+
+#endif // DERIVED_SERIES_H
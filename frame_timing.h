@@ -0,0 +1,218 @@
+#ifndef FRAME_TIMING_H
+#define FRAME_TIMING_H
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+
+#include <array>
+#include <algorithm>
+
+#define FRAME_TIMING_WINDOW 128 ///< Number of last measurements of each phase in rolling statistics
+
+///
+/// \brief The FRAME_PHASE enum - phases of frame pipeline that are measured
+///
+enum class FRAME_PHASE : int {
+    UPDATE_GRID = 0, ///< OpenGLWidget::updateGrid
+    GRID_VALUES,     ///< MainWidget::updateGridValues, rebuilding of labels
+    DATA_UPLOAD,     ///< Storing of graph data and fitting of scene (addGraph, setValuesGraph)
+    PAINT,           ///< CPU time of paintGL
+    DRAW_GPU,        ///< GPU time of draw passes, measured with timer queries
+    RESET_SCENE,     ///< OpenGLWidget::resetScene, fitting of scene to extents of graphs
+    COUNT
+};
+
+///
+/// \brief framePhaseName - name of phase, used as key in JSON
+/// \param phase - phase of frame pipeline
+/// \return - name of phase
+///
+inline const char *framePhaseName(FRAME_PHASE phase)
+{
+    switch (phase) {
+    case FRAME_PHASE::UPDATE_GRID:
+        return "updateGrid";
+    case FRAME_PHASE::GRID_VALUES:
+        return "updateGridValues";
+    case FRAME_PHASE::DATA_UPLOAD:
+        return "dataUpload";
+    case FRAME_PHASE::PAINT:
+        return "paintGL";
+    case FRAME_PHASE::DRAW_GPU:
+        return "drawGPU";
+    case FRAME_PHASE::RESET_SCENE:
+        return "resetScene";
+    default:
+        return "unknown";
+    }
+}
+
+///
+/// \brief The PhaseStatistics struct - rolling statistics of one phase, milliseconds
+///
+struct PhaseStatistics {
+    double   p50{0}; ///< Median
+    double   p95{0}; ///< 95th percentile
+    double   max{0}; ///< Maximum
+    size_t count{0}; ///< Number of measurements in window
+};
+
+///
+/// \brief The FrameStatistics struct - rolling statistics of all phases
+///
+struct FrameStatistics {
+    std::array<PhaseStatistics, static_cast<size_t>(FRAME_PHASE::COUNT)> phases; ///< Statistics for each phase
+    bool                                                       gpuTimer{false}; ///< Whether GL timer queries available
+
+    // --- Main methods ---
+
+    ///
+    /// \brief operator[] - statistics of phase
+    /// \param phase - phase of frame pipeline
+    /// \return - statistics of phase
+    ///
+    const PhaseStatistics &operator[](FRAME_PHASE phase) const
+    {
+        return phases[static_cast<size_t>(phase)];
+    }
+
+    ///
+    /// \brief toJson - convert statistics in JSON, so results can be stored and compared between releases
+    /// \return - object {"gpuTimer": bool, "phases": {"<phase>": {"p50", "p95", "max", "count"}}}
+    ///
+    QJsonObject toJson() const
+    {
+        QJsonObject phasesJson;
+        for (size_t i = 0; i < phases.size(); ++i) {
+            QJsonObject phaseJson;
+            phaseJson["p50"] = phases[i].p50;
+            phaseJson["p95"] = phases[i].p95;
+            phaseJson["max"] = phases[i].max;
+            phaseJson["count"] = static_cast<qint64>(phases[i].count);
+            phasesJson[framePhaseName(static_cast<FRAME_PHASE>(i))] = phaseJson;
+        }
+
+        QJsonObject result;
+        result["gpuTimer"] = gpuTimer;
+        result["phases"] = phasesJson;
+
+        return result;
+    }
+};
+
+///
+/// \brief The FrameTiming class - keep last measurements of each phase and count statistics on demand
+///
+class FrameTiming
+{
+public:
+
+    // --- Helper classes ---
+
+    ///
+    /// \brief The ScopedTimer class - measure time of scope and add it to FrameTiming
+    ///
+    class ScopedTimer
+    {
+    public:
+
+        // --- Constructors/destructors ---
+
+        ScopedTimer(FrameTiming &timing, FRAME_PHASE phase)
+            : m_timing{timing}, m_phase{phase}
+        {
+            m_timer.start();
+        }
+        ~ScopedTimer()
+        {
+            m_timing.addSample(m_phase, m_timer.nsecsElapsed() / 1e6);
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+
+        // --- Fields ---
+
+        FrameTiming   &m_timing; ///< Where measurement is added
+        FRAME_PHASE     m_phase; ///< Measured phase
+        QElapsedTimer   m_timer; ///< Timer of scope
+    };
+
+    // --- Main methods ---
+
+    ///
+    /// \brief addSample - add measurement of phase
+    /// \param phase - phase of frame pipeline
+    /// \param ms - duration in milliseconds
+    ///
+    void addSample(FRAME_PHASE phase, double ms)
+    {
+        size_t index = static_cast<size_t>(phase);
+        m_samples[index][m_total[index] % FRAME_TIMING_WINDOW] = ms;
+        ++m_total[index];
+    }
+
+    ///
+    /// \brief clear - drop all measurements
+    ///
+    void clear()
+    {
+        m_total.fill(0);
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief getStatistics - count p50/p95/max of each phase over last measurements
+    /// \return - statistics of all phases
+    ///
+    FrameStatistics getStatistics() const
+    {
+        FrameStatistics result;
+        std::array<double, FRAME_TIMING_WINDOW> sorted;
+
+        for (size_t i = 0; i < m_samples.size(); ++i) {
+            size_t count = std::min<size_t>(m_total[i], FRAME_TIMING_WINDOW);
+            if (count == 0)
+                continue;
+
+            std::copy(m_samples[i].begin(), m_samples[i].begin() + count, sorted.begin());
+            std::sort(sorted.begin(), sorted.begin() + count);
+
+            PhaseStatistics &phase = result.phases[i];
+            phase.p50 = sorted[(count - 1) / 2];
+            phase.p95 = sorted[(count - 1) * 95 / 100];
+            phase.max = sorted[count - 1];
+            phase.count = count;
+        }
+
+        return result;
+    }
+
+    ///
+    /// \brief getLastSample - get last measurement of phase
+    /// \param phase - phase of frame pipeline
+    /// \return - duration in milliseconds, 0 if phase wasn't measured
+    ///
+    double getLastSample(FRAME_PHASE phase) const
+    {
+        size_t index = static_cast<size_t>(phase);
+        if (m_total[index] == 0)
+            return 0;
+
+        return m_samples[index][(m_total[index] - 1) % FRAME_TIMING_WINDOW];
+    }
+
+private:
+
+    // --- Fields ---
+
+    static constexpr size_t PHASE_COUNT = static_cast<size_t>(FRAME_PHASE::COUNT);
+
+    std::array<std::array<double, FRAME_TIMING_WINDOW>, PHASE_COUNT> m_samples{}; ///< Ring of measurements for each phase
+    std::array<size_t, PHASE_COUNT>                                    m_total{}; ///< Total measurements for each phase
+};
+
+#endif // FRAME_TIMING_H
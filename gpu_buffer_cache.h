@@ -0,0 +1,181 @@
+#ifndef GPU_BUFFER_CACHE_H
+#define GPU_BUFFER_CACHE_H
+
+#include <QOpenGLBuffer>
+
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+#define GPU_HASH_SEED 0xCBF29CE484222325ull ///< Initial value of hash of series
+
+///
+/// \brief hashSeries - hash of data of series, equal series in different graphs get one GPU buffer
+/// \param data - data of series
+/// \param bytes - size of data in bytes
+/// \param seed - initial value, e.g. size of series or hash of previous part
+/// \return - hash of data
+///
+inline quint64 hashSeries(const void *data, size_t bytes, quint64 seed = GPU_HASH_SEED)
+{
+    const uchar *bytesData = static_cast<const uchar *>(data);
+    quint64 result = seed;
+
+    auto mix = [&result](quint64 word) {
+        result = (result ^ word) * 0x9E3779B97F4A7C15ull;
+        result ^= result >> 32;
+    };
+
+    size_t i{};
+    for (; i + sizeof(quint64) <= bytes; i += sizeof(quint64)) {
+        quint64 word;
+        std::memcpy(&word, bytesData + i, sizeof(word));
+        mix(word);
+    }
+    if (i < bytes) {
+        quint64 word{};
+        std::memcpy(&word, bytesData + i, bytes - i);
+        mix(word);
+    }
+
+    return result;
+}
+
+///
+/// \brief The GpuBufferCache class - vertex buffers shared by widgets of one context group, buffer is uploaded
+/// once for equal series and destroyed when last graph releases it. Used only from GUI thread
+///
+class GpuBufferCache
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    GpuBufferCache() = default;
+    ~GpuBufferCache() = default;
+
+    GpuBufferCache(const GpuBufferCache &) = delete;
+    GpuBufferCache &operator=(const GpuBufferCache &) = delete;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief acquire - take reference to existing buffer
+    /// \param key - hash of series
+    /// \return - buffer, nullptr if series isn't uploaded
+    ///
+    QOpenGLBuffer *acquire(quint64 key)
+    {
+        auto found = m_entries.find(key);
+        if (found == m_entries.end())
+            return nullptr;
+
+        ++found->second.refs;
+        return found->second.buffer.get();
+    }
+
+    ///
+    /// \brief create - upload series in new buffer with one reference, context of group must be current
+    /// \param key - hash of series
+    /// \param data - vertices
+    /// \param bytes - size of vertices in bytes
+    /// \return - buffer, nullptr if buffer can't be created
+    ///
+    QOpenGLBuffer *create(quint64 key, const void *data, int bytes)
+    {
+        auto buffer = std::make_unique<QOpenGLBuffer>(QOpenGLBuffer::VertexBuffer);
+        if (!buffer->create())
+            return nullptr;
+
+        buffer->setUsagePattern(QOpenGLBuffer::StaticDraw);
+        buffer->bind();
+        buffer->allocate(data, bytes);
+        buffer->release();
+
+        Entry &entry = m_entries[key];
+        entry.buffer = std::move(buffer);
+        entry.refs = 1;
+        entry.bytes = bytes;
+        m_memorySize += bytes;
+
+        return entry.buffer.get();
+    }
+
+    ///
+    /// \brief get - get buffer without taking reference
+    /// \param key - hash of series
+    /// \return - buffer, nullptr if series isn't uploaded
+    ///
+    QOpenGLBuffer *get(quint64 key)
+    {
+        auto found = m_entries.find(key);
+        return found == m_entries.end() ? nullptr : found->second.buffer.get();
+    }
+
+    ///
+    /// \brief release - drop reference to buffer, unused buffer is destroyed by collect
+    /// \param key - hash of series
+    ///
+    void release(quint64 key)
+    {
+        auto found = m_entries.find(key);
+        if (found != m_entries.end() && found->second.refs > 0)
+            --found->second.refs;
+    }
+
+    ///
+    /// \brief collect - destroy unused buffers, context of group must be current
+    ///
+    void collect()
+    {
+        for (auto entry = m_entries.begin(); entry != m_entries.end();) {
+            if (entry->second.refs == 0) {
+                m_memorySize -= entry->second.bytes;
+                entry->second.buffer->destroy();
+                entry = m_entries.erase(entry);
+            } else {
+                ++entry;
+            }
+        }
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief memorySize - bytes taken by buffers
+    /// \return - bytes
+    ///
+    size_t memorySize() const
+    {
+        return m_memorySize;
+    }
+
+    ///
+    /// \brief count - number of buffers
+    /// \return - number of buffers
+    ///
+    size_t count() const
+    {
+        return m_entries.size();
+    }
+
+private:
+
+    // --- Helper structs ---
+
+    ///
+    /// \brief The Entry struct - buffer of series
+    ///
+    struct Entry {
+        std::unique_ptr<QOpenGLBuffer> buffer; ///< Vertex buffer
+        size_t                        refs{0}; ///< Number of graphs which use buffer
+        size_t                       bytes{0}; ///< Size of buffer in bytes
+    };
+
+    // --- Fields ---
+
+    std::unordered_map<quint64, Entry>  m_entries; ///< Buffer of each series
+    size_t                           m_memorySize{0}; ///< Bytes taken by buffers
+};
+
+#endif // GPU_BUFFER_CACHE_H
@@ -0,0 +1,226 @@
+#ifndef GRAPH_SOURCE_H
+#define GRAPH_SOURCE_H
+
+#include "lod_pyramid.h"
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#define GRAPH_FILE_MAGIC 0x57443247 ///< "G2DW", first bytes of graph file
+#define GRAPH_FILE_VERSION 1 ///< Version of raw graph file
+
+///
+/// \brief The SAMPLE_TYPE enum - type of samples stored in file
+///
+enum class SAMPLE_TYPE : quint32 {
+    INT16 = 0,
+    INT32,
+    FLOAT32,
+    FLOAT64
+};
+
+///
+/// \brief sampleTypeSize - size of sample in bytes
+/// \param sampleType - type of samples
+/// \return - size in bytes, 0 if type is unknown
+///
+inline size_t sampleTypeSize(SAMPLE_TYPE sampleType)
+{
+    switch (sampleType) {
+    case SAMPLE_TYPE::INT16:
+        return sizeof(qint16);
+    case SAMPLE_TYPE::INT32:
+        return sizeof(qint32);
+    case SAMPLE_TYPE::FLOAT32:
+        return sizeof(float);
+    case SAMPLE_TYPE::FLOAT64:
+        return sizeof(double);
+    default:
+        return 0;
+    }
+}
+
+///
+/// \brief sampleTypeOf - type of samples in which graph values are stored in file
+/// \return - type of samples
+///
+template<typename type>
+constexpr SAMPLE_TYPE sampleTypeOf()
+{
+    if constexpr(std::is_same_v<type, float>) {
+        return SAMPLE_TYPE::FLOAT32;
+    } else if constexpr(std::is_same_v<type, double>) {
+        return SAMPLE_TYPE::FLOAT64;
+    } else {
+        static_assert(std::is_integral_v<type> && (sizeof(type) == sizeof(qint16) || sizeof(type) == sizeof(qint32)),
+                      "Unsupported type of samples");
+        return sizeof(type) == sizeof(qint16) ? SAMPLE_TYPE::INT16 : SAMPLE_TYPE::INT32;
+    }
+}
+
+///
+/// \brief convertSamples - convert raw samples of file in type of graph
+/// \param sampleType - type of raw samples
+/// \param data - raw samples
+/// \param count - number of samples
+/// \param values - where converted samples are written
+///
+template<typename type>
+void convertSamples(SAMPLE_TYPE sampleType, const uchar *data, size_t count, type *values)
+{
+    auto convert = [&](auto sample) {
+        using sampleType_t = decltype(sample);
+        const sampleType_t *samples = reinterpret_cast<const sampleType_t *>(data);
+        for (size_t i = 0; i < count; ++i)
+            values[i] = static_cast<type>(samples[i]);
+    };
+
+    switch (sampleType) {
+    case SAMPLE_TYPE::INT16:
+        convert(qint16{});
+        break;
+    case SAMPLE_TYPE::INT32:
+        convert(qint32{});
+        break;
+    case SAMPLE_TYPE::FLOAT32:
+        convert(float{});
+        break;
+    case SAMPLE_TYPE::FLOAT64:
+        convert(double{});
+        break;
+    }
+}
+
+///
+/// \brief The GraphFileHeader struct - header of raw graph file, samples follow it
+///
+struct GraphFileHeader {
+    quint32      magic{GRAPH_FILE_MAGIC}; ///< GRAPH_FILE_MAGIC
+    quint32    version{GRAPH_FILE_VERSION}; ///< Version of format
+    quint32                  sampleType{0}; ///< SAMPLE_TYPE of samples
+    quint32 headerSize{sizeof(GraphFileHeader)}; ///< Offset of samples from beginning of file
+    double                   startPoint{0}; ///< Starting point of graph
+    double                         step{1}; ///< Distance between each value on graph
+    quint64                       count{0}; ///< Number of samples
+};
+
+///
+/// \brief The GraphSource class - graph whose samples aren't kept in GraphData::graph, they are read on demand
+///
+template<typename type>
+class GraphSource
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    GraphSource() = default;
+    virtual ~GraphSource() = default;
+
+    GraphSource(const GraphSource &) = delete;
+    GraphSource &operator=(const GraphSource &) = delete;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief read - read samples of graph
+    /// \param first - index of first sample
+    /// \param count - number of samples, clamped to size of graph
+    /// \param values - where samples are written
+    /// \return - true is all good, false is mistake
+    ///
+    virtual bool read(size_t first, size_t count, std::vector<type> &values) = 0;
+
+    // --- Setters ---
+
+    ///
+    /// \brief setPyramidCallback - set function called (from any thread) when new levels of detail are published
+    /// \param callback - called function
+    ///
+    void setPyramidCallback(std::function<void()> callback)
+    {
+        std::lock_guard<std::mutex> lock{m_callbackMutex};
+        m_pyramidCallback = std::move(callback);
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief size - number of samples of graph
+    /// \return - number of samples
+    ///
+    virtual size_t size() const = 0;
+
+    ///
+    /// \brief startPoint - starting point of graph
+    /// \return - starting point
+    ///
+    virtual double startPoint() const = 0;
+
+    ///
+    /// \brief step - distance between each value on graph
+    /// \return - distance
+    ///
+    virtual double step() const = 0;
+
+    ///
+    /// \brief getExtentsY - get minimum and maximum value of graph
+    /// \param min - minimum value
+    /// \param max - maximum value
+    /// \return - false if extents aren't known yet
+    ///
+    virtual bool getExtentsY(type &min, type &max) const
+    {
+        auto pyramid = getPyramid();
+        if (!pyramid || pyramid->samples() == 0)
+            return false;
+
+        auto minMax = pyramid->getMinMax();
+        min = minMax.min;
+        max = minMax.max;
+
+        return true;
+    }
+
+    ///
+    /// \brief getPyramid - get levels of detail, they may cover only beginning of graph while they are building
+    /// \return - levels of detail, nullptr if they aren't ready
+    ///
+    std::shared_ptr<const MinMaxPyramid<type>> getPyramid() const
+    {
+        return std::atomic_load(&m_pyramid);
+    }
+
+protected:
+
+    // --- Helper methods ---
+
+    ///
+    /// \brief publishPyramid - replace levels of detail atomically and notify renderer
+    /// \param pyramid - new levels of detail
+    ///
+    void publishPyramid(std::shared_ptr<const MinMaxPyramid<type>> pyramid)
+    {
+        std::atomic_store(&m_pyramid, std::move(pyramid));
+
+        std::lock_guard<std::mutex> lock{m_callbackMutex};
+        if (m_pyramidCallback)
+            m_pyramidCallback();
+    }
+
+private:
+
+    // --- Fields ---
+
+    std::shared_ptr<const MinMaxPyramid<type>>  m_pyramid; ///< Published levels of detail
+    std::mutex                            m_callbackMutex; ///< Guard of callback
+    std::function<void()>               m_pyramidCallback; ///< Called when levels of detail are published
+};
+
+#endif // GRAPH_SOURCE_H
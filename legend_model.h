@@ -0,0 +1,272 @@
+#ifndef LEGEND_MODEL_H
+#define LEGEND_MODEL_H
+
+#include <QAbstractListModel>
+#include <QColor>
+#include <QFont>
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+///
+/// \brief The LegendModel class - graphs of tab for legend view. View creates items only for visible rows, so
+/// legend of thousands of graphs is cheap to lay out. Row is checkable, check state is visibility of graph
+///
+class LegendModel : public QAbstractListModel
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    explicit LegendModel(QObject *parent = nullptr)
+        : QAbstractListModel{parent}
+    {}
+    ~LegendModel() = default;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief addGraph - add row of graph
+    /// \param idGraph - id of graph
+    /// \param name - graph name
+    /// \param color - graph color
+    ///
+    void addGraph(int idGraph, const QString &name, QRgb color)
+    {
+        int row = m_entries.size();
+
+        beginInsertRows({}, row, row);
+        m_entries.push_back(Entry{idGraph, name, color, true});
+        m_rows[idGraph] = row;
+        endInsertRows();
+    }
+
+    ///
+    /// \brief deleteGraph - delete row of graph
+    /// \param idGraph - id of graph
+    ///
+    void deleteGraph(int idGraph)
+    {
+        auto found = m_rows.find(idGraph);
+        if (found == m_rows.end())
+            return;
+
+        int row = found->second;
+
+        beginRemoveRows({}, row, row);
+        m_entries.erase(m_entries.begin() + row);
+        m_rows.erase(found);
+        for (size_t i = row; i < m_entries.size(); ++i)
+            m_rows[m_entries[i].idGraph] = i;
+        endRemoveRows();
+    }
+
+    // --- Setters ---
+
+    ///
+    /// \brief setVisibleCallback - set function called when visibility of graph is changed from legend
+    /// \param callback - called function, takes id of graph and whether to show it
+    ///
+    void setVisibleCallback(std::function<void(int, bool)> callback)
+    {
+        m_visibleCallback = std::move(callback);
+    }
+
+    ///
+    /// \brief setGraphVisible - whether to show graph, callback isn't called
+    /// \param idGraph - id of graph
+    /// \param show - whether to show item
+    ///
+    void setGraphVisible(int idGraph, bool show)
+    {
+        changeEntry(idGraph, Qt::CheckStateRole, [show](Entry &entry) {
+            entry.show = show;
+        });
+    }
+
+    ///
+    /// \brief setRowsVisible - whether to show graphs of several rows, callback is called for changed graphs
+    /// \param rows - rows of graphs
+    /// \param show - whether to show items
+    ///
+    void setRowsVisible(const std::vector<int> &rows, bool show)
+    {
+        if (rows.empty())
+            return;
+
+        int first = rows.front(), last = rows.front();
+        for (int row : rows) {
+            Entry &entry = m_entries[row];
+            if (entry.show == show)
+                continue;
+
+            entry.show = show;
+            first = std::min(first, row);
+            last = std::max(last, row);
+            if (m_visibleCallback)
+                m_visibleCallback(entry.idGraph, show);
+        }
+
+        // One notification for all rows, view repaints only rows which it shows
+        emit dataChanged(index(first), index(last), {Qt::CheckStateRole});
+    }
+
+    ///
+    /// \brief setNameGraph - set graph name
+    /// \param idGraph - id of graph
+    /// \param name - graph name
+    ///
+    void setNameGraph(int idGraph, const QString &name)
+    {
+        changeEntry(idGraph, Qt::DisplayRole, [&name](Entry &entry) {
+            entry.name = name;
+        });
+    }
+
+    ///
+    /// \brief setColorGraph - set graph color
+    /// \param idGraph - id of graph
+    /// \param color - graph color
+    ///
+    void setColorGraph(int idGraph, QRgb color)
+    {
+        changeEntry(idGraph, Qt::DecorationRole, [color](Entry &entry) {
+            entry.color = color;
+        });
+    }
+
+    ///
+    /// \brief setColorText - set color of graph names
+    /// \param color - text color
+    ///
+    void setColorText(QRgb color)
+    {
+        m_colorText = color;
+        changeAll(Qt::ForegroundRole);
+    }
+
+    ///
+    /// \brief setFontText - set font of graph names
+    /// \param font - font family, may be quoted as in style sheet
+    ///
+    void setFontText(QString font)
+    {
+        m_font = QFont{font.remove('\'')};
+        changeAll(Qt::FontRole);
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief graphVisible - whether graph is shown
+    /// \param idGraph - id of graph
+    /// \return - whether item is shown, false if graph isn't in legend
+    ///
+    bool graphVisible(int idGraph) const
+    {
+        auto found = m_rows.find(idGraph);
+        return found != m_rows.end() && m_entries[found->second].show;
+    }
+
+    // --- Model methods ---
+
+    int rowCount(const QModelIndex &parent = {}) const override
+    {
+        return parent.isValid() ? 0 : m_entries.size();
+    }
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    {
+        if (!index.isValid() || index.row() >= m_entries.size())
+            return {};
+
+        const Entry &entry = m_entries[index.row()];
+        switch (role) {
+        case Qt::DisplayRole:
+            return entry.name;
+        case Qt::DecorationRole:
+            return QColor{entry.color};
+        case Qt::CheckStateRole:
+            return entry.show ? Qt::Checked : Qt::Unchecked;
+        case Qt::ForegroundRole:
+            return QColor{m_colorText};
+        case Qt::FontRole:
+            return m_font;
+        default:
+            return {};
+        }
+    }
+
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override
+    {
+        if (!index.isValid() || role != Qt::CheckStateRole)
+            return false;
+
+        setRowsVisible({index.row()}, value.toInt() == Qt::Checked);
+
+        return true;
+    }
+
+    Qt::ItemFlags flags(const QModelIndex &index) const override
+    {
+        if (!index.isValid())
+            return Qt::NoItemFlags;
+
+        return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable | Qt::ItemNeverHasChildren;
+    }
+
+private:
+
+    // --- Helper structs ---
+
+    ///
+    /// \brief The Entry struct - row of graph
+    ///
+    struct Entry {
+        int           idGraph; ///< Id of graph
+        QString          name; ///< Graph name
+        QRgb            color; ///< Graph color
+        bool             show; ///< Show or unshow graph
+    };
+
+    // --- Helper methods ---
+
+    ///
+    /// \brief changeEntry - change row of graph and notify view
+    /// \param idGraph - id of graph
+    /// \param role - changed role
+    /// \param change - function which changes row
+    ///
+    template<typename Function>
+    void changeEntry(int idGraph, int role, Function change)
+    {
+        auto found = m_rows.find(idGraph);
+        if (found == m_rows.end())
+            return;
+
+        change(m_entries[found->second]);
+        emit dataChanged(index(found->second), index(found->second), {role});
+    }
+
+    ///
+    /// \brief changeAll - notify view that role of all rows is changed
+    /// \param role - changed role
+    ///
+    void changeAll(int role)
+    {
+        if (!m_entries.empty())
+            emit dataChanged(index(0), index(m_entries.size() - 1), {role});
+    }
+
+    // --- Fields ---
+
+    std::vector<Entry>                 m_entries; ///< Rows of graphs
+    std::unordered_map<int, int>          m_rows; ///< Row of each graph
+    std::function<void(int, bool)> m_visibleCallback; ///< Called when visibility is changed from legend
+    QRgb                   m_colorText{qRgb(0, 0, 0)}; ///< Color of graph names
+    QFont                                 m_font; ///< Font of graph names
+};
+
+#endif // LEGEND_MODEL_H
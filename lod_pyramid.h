@@ -0,0 +1,310 @@
+#ifndef LOD_PYRAMID_H
+#define LOD_PYRAMID_H
+
+#include <vector>
+#include <algorithm>
+
+#define LOD_BASE_BLOCK 64 ///< Default number of samples in one bucket of finest level
+
+///
+/// \brief The MinMaxPyramid class - levels of detail of graph, each bucket of level keeps minimum and maximum
+/// of its samples, bucket of next level covers two buckets of previous one. Levels keep only complete buckets,
+/// samples which don't fill bucket are covered by finer levels and partial bucket
+///
+template<typename type>
+class MinMaxPyramid
+{
+public:
+
+    // --- Helper structs ---
+
+    ///
+    /// \brief The Bucket struct - minimum and maximum of samples of bucket
+    ///
+    struct Bucket {
+        type min; ///< Minimum of samples
+        type max; ///< Maximum of samples
+    };
+
+    // --- Constructors/destructors ---
+
+    explicit MinMaxPyramid(size_t baseBlock = LOD_BASE_BLOCK)
+        : m_baseBlock{baseBlock}, m_samples{0}, m_partialCount{0}
+    {}
+    ~MinMaxPyramid() = default;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief computeBucket - count minimum and maximum of samples
+    /// \param values - samples
+    /// \param count - number of samples, must be > 0
+    /// \return - minimum and maximum of samples
+    ///
+    static Bucket computeBucket(const type *values, size_t count)
+    {
+        Bucket bucket{values[0], values[0]};
+        for (size_t i = 1; i < count; ++i) {
+            bucket.min = std::min(bucket.min, values[i]);
+            bucket.max = std::max(bucket.max, values[i]);
+        }
+
+        return bucket;
+    }
+
+    ///
+    /// \brief combine - union of two buckets
+    /// \return - minimum and maximum of both buckets
+    ///
+    static Bucket combine(const Bucket &first, const Bucket &second)
+    {
+        return Bucket{std::min(first.min, second.min), std::max(first.max, second.max)};
+    }
+
+    ///
+    /// \brief append - add samples to end of graph, levels are updated incrementally
+    /// \param values - samples
+    /// \param count - number of samples
+    ///
+    void append(const type *values, size_t count)
+    {
+        size_t i{};
+        while (i < count) {
+            size_t take = std::min(count - i, m_baseBlock - m_partialCount);
+            Bucket bucket = computeBucket(values + i, take);
+            m_partial = m_partialCount ? combine(m_partial, bucket) : bucket;
+            m_partialCount += take;
+            m_samples += take;
+            i += take;
+
+            if (m_partialCount == m_baseBlock) {
+                addBucket(0, m_partial);
+                m_partialCount = 0;
+            }
+        }
+    }
+
+    ///
+    /// \brief setBaseLevel - replace pyramid with finest level counted elsewhere (e.g. in parallel by chunks),
+    /// coarser levels are built from it
+    /// \param level - complete buckets of finest level
+    /// \param partial - bucket of samples which don't fill bucket
+    /// \param partialCount - number of samples in partial bucket
+    ///
+    void setBaseLevel(std::vector<Bucket> &&level, Bucket partial, size_t partialCount)
+    {
+        m_levels.clear();
+        m_levels.push_back(std::move(level));
+        m_partial = partial;
+        m_partialCount = partialCount;
+        m_samples = m_levels[0].size() * m_baseBlock + partialCount;
+
+        for (size_t l = 0; m_levels[l].size() >= 2; ++l) {
+            std::vector<Bucket> next;
+            next.reserve(m_levels[l].size() / 2);
+            for (size_t i = 0; i + 1 < m_levels[l].size(); i += 2)
+                next.push_back(combine(m_levels[l][i], m_levels[l][i + 1]));
+            m_levels.push_back(std::move(next));
+        }
+    }
+
+    ///
+    /// \brief forEachBucket - walk samples [first, last) by buckets of level, tail that level doesn't cover
+    /// is walked by finer levels and partial bucket
+    /// \param level - level of detail, clamped to existing levels
+    /// \param first - first sample, rounded down to bucket border
+    /// \param last - sample after last
+    /// \param func - called with (index of first sample of bucket, number of samples, bucket)
+    ///
+    template<typename Func>
+    void forEachBucket(size_t level, size_t first, size_t last, Func func) const
+    {
+        last = std::min(last, m_samples);
+        if (first >= last)
+            return;
+
+        if (!m_levels.empty()) {
+            level = std::min(level, m_levels.size() - 1);
+            size_t pos = first / blockSize(level) * blockSize(level);
+
+            for (size_t l = level + 1; l-- > 0;) {
+                size_t block = blockSize(l);
+                size_t covered = m_levels[l].size() * block;
+                for (; pos < last && pos + block <= covered; pos += block)
+                    func(pos, block, m_levels[l][pos / block]);
+            }
+            first = pos;
+        }
+
+        if (m_partialCount && first < last)
+            func(m_samples - m_partialCount, m_partialCount, m_partial);
+    }
+
+    ///
+    /// \brief rangeMinMax - exact minimum and maximum of samples [first, last), middle is taken from largest
+    /// aligned buckets and edges are scanned in raw samples, so cost is logarithmic in size of range
+    /// \param values - raw samples of graph, pyramid is built from them
+    /// \param first - first sample
+    /// \param last - sample after last, must be > first
+    /// \return - minimum and maximum of samples
+    ///
+    Bucket rangeMinMax(const type *values, size_t first, size_t last) const
+    {
+        size_t covered = m_levels.empty() ? 0 : m_levels[0].size() * m_baseBlock;
+        size_t pos = std::min(last, std::max(first, (first + m_baseBlock - 1) / m_baseBlock * m_baseBlock));
+        if (pos >= covered)
+            return computeBucket(values + first, last - first);
+
+        // Head before first bucket, at least one sample so result is defined
+        Bucket result = computeBucket(values + first, std::max<size_t>(pos - first, 1));
+
+        size_t end = std::max(pos, std::min(last, covered) / m_baseBlock * m_baseBlock);
+        if (pos < end)
+            result = combine(result, blocksMinMax(pos, end));
+        if (end < last)
+            result = combine(result, computeBucket(values + end, last - end));
+
+        return result;
+    }
+
+    ///
+    /// \brief blocksMinMax - exact minimum and maximum of complete buckets of finest level, taken from largest
+    /// aligned buckets, so raw samples aren't needed
+    /// \param first - first sample, multiple of base block
+    /// \param last - sample after last, multiple of base block, must be > first and covered by finest level
+    /// \return - minimum and maximum of samples
+    ///
+    Bucket blocksMinMax(size_t first, size_t last) const
+    {
+        Bucket result = m_levels[0][first / m_baseBlock];
+        for (size_t pos = first; pos < last;) {
+            size_t level{};
+            while (level + 1 < m_levels.size() && pos % blockSize(level + 1) == 0
+                    && pos + blockSize(level + 1) <= last && pos / blockSize(level + 1) < m_levels[level + 1].size())
+                ++level;
+
+            result = combine(result, m_levels[level][pos / blockSize(level)]);
+            pos += blockSize(level);
+        }
+
+        return result;
+    }
+
+    ///
+    /// \brief chooseLevel - choose coarsest level whose bucket isn't wider than given number of samples
+    /// \param samplesPerPixel - number of samples in one pixel
+    /// \return - level of detail, -1 if raw samples should be drawn
+    ///
+    int chooseLevel(double samplesPerPixel) const
+    {
+        if (m_levels.empty() || samplesPerPixel < m_baseBlock)
+            return -1;
+
+        int level{};
+        while (level + 1 < static_cast<int>(m_levels.size()) && blockSize(level + 1) <= samplesPerPixel)
+            ++level;
+
+        return level;
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief getMinMax - minimum and maximum of all samples
+    /// \return - bucket of all samples, undefined if pyramid is empty
+    ///
+    Bucket getMinMax() const
+    {
+        Bucket result{};
+        bool first{true};
+        forEachBucket(m_levels.size(), 0, m_samples, [&](size_t, size_t, const Bucket & bucket) {
+            result = first ? bucket : combine(result, bucket);
+            first = false;
+        });
+
+        return result;
+    }
+
+    ///
+    /// \brief blockSize - number of samples in bucket of level
+    /// \param level - level of detail
+    /// \return - number of samples
+    ///
+    size_t blockSize(size_t level) const
+    {
+        return m_baseBlock << level;
+    }
+
+    ///
+    /// \brief levelCount - number of levels
+    /// \return - number of levels
+    ///
+    size_t levelCount() const
+    {
+        return m_levels.size();
+    }
+
+    ///
+    /// \brief level - complete buckets of level
+    /// \param level - level of detail
+    /// \return - buckets of level
+    ///
+    const std::vector<Bucket> &level(size_t level) const
+    {
+        return m_levels[level];
+    }
+
+    ///
+    /// \brief samples - number of samples covered by pyramid
+    /// \return - number of samples
+    ///
+    size_t samples() const
+    {
+        return m_samples;
+    }
+
+    ///
+    /// \brief memorySize - bytes taken by buckets
+    /// \return - bytes
+    ///
+    size_t memorySize() const
+    {
+        size_t result{};
+        for (const auto &level : m_levels)
+            result += level.capacity() * sizeof(Bucket);
+
+        return result;
+    }
+
+private:
+
+    // --- Helper methods ---
+
+    ///
+    /// \brief addBucket - add complete bucket to level, when two buckets are paired bucket of next level is made
+    /// \param level - level of detail
+    /// \param bucket - complete bucket
+    ///
+    void addBucket(size_t level, const Bucket &bucket)
+    {
+        if (m_levels.size() <= level)
+            m_levels.emplace_back();
+
+        std::vector<Bucket> &buckets = m_levels[level];
+        buckets.push_back(bucket);
+        if (buckets.size() % 2 == 0)
+            addBucket(level + 1, combine(buckets[buckets.size() - 2], buckets.back()));
+    }
+
+private:
+
+    // --- Fields ---
+
+    size_t                         m_baseBlock; ///< Number of samples in bucket of finest level
+    size_t                           m_samples; ///< Number of samples covered by pyramid
+    std::vector<std::vector<Bucket>>  m_levels; ///< Complete buckets of each level, finest is first
+    Bucket                           m_partial; ///< Bucket of samples which don't fill bucket of finest level
+    size_t                      m_partialCount; ///< Number of samples in partial bucket
+};
+
+#endif // LOD_PYRAMID_H
@@ -4,6 +4,10 @@
 #include <QDebug>
 
 #include "opengl_widget.h"
+#include "pyramid_file.h"
+#include "legend_model.h"
+#include "spectrum.h"
+#include "derived_series.h"
 
 #include <QTabWidget>
 #include <QVBoxLayout>
@@ -15,10 +19,21 @@
 #include <QStyle>
 #include <QDialog>
 #include <QDoubleSpinBox>
+#include <QListView>
+#include <QLineEdit>
+#include <QSortFilterProxyModel>
 
 #define SPIN_GLOB_MIN -100.0
 #define SPIN_GLOB_MAX 100.0
 #define SPIN_DECIMALS 3
+#define SPECTRUM_UPDATE_MS 16 ///< Period of update of spectra, about frame of display, milliseconds
+#define DERIVED_UPDATE_MS 16 ///< Period of evaluation of derived graphs, milliseconds
+
+///
+/// \brief The MainWidgetProbe class - access to internal steps of frame, defined by benchmarks and tests
+///
+template<typename type, TYPE_VISIBLE T>
+class MainWidgetProbe;
 
 ///
 /// \brief The MainWidget class - widget for interaction with visualized data
@@ -26,12 +41,38 @@
 template<typename type, TYPE_VISIBLE T>
 class MainWidget : public QWidget
 {
+    friend class MainWidgetProbe<type, T>;
+
 public:
 
     // --- Helper aliases ---
 
     using OGLW = OpenGLWidget<type, T>;
 
+    // --- Helper classes ---
+
+    ///
+    /// \brief The UpdateGuard class - transaction which is ended when guard goes out of scope
+    ///
+    class UpdateGuard
+    {
+    public:
+        explicit UpdateGuard(MainWidget &widget) : m_widget{widget}
+        {
+            m_widget.beginUpdate();
+        }
+        ~UpdateGuard()
+        {
+            m_widget.endUpdate();
+        }
+
+        UpdateGuard(const UpdateGuard &) = delete;
+        UpdateGuard &operator=(const UpdateGuard &) = delete;
+
+    private:
+        MainWidget &m_widget; ///< Widget of transaction
+    };
+
     // --- Constructors/destructors ---
 
     MainWidget(QWidget *parent = nullptr);
@@ -58,6 +99,76 @@ public:
     ///
     int addGraph(int idTab, std::vector<type> &graph, QRgb color, QString name = "Graph");
 
+    ///
+    /// \brief addGraph - add graph whose values have own X, e.g. irregular events
+    /// \param idTab - id of tab be interacted with
+    /// \param graph - array of graph values
+    /// \param x - sorted X of each value
+    /// \param color - item color
+    /// \param name - item name
+    /// \return - id, if id > 0, then id of created graph, else if id == -1, then graph isn't create
+    ///
+    int addGraph(int idTab, std::vector<type> &graph, const std::vector<double> &x, QRgb color,
+                 QString name = "Graph");
+
+    ///
+    /// \brief addGraph - add graph whose values have timestamps, X of value is its timestamp. Timestamps are
+    /// kept relative to first one, so nanoseconds stay exact in graph of any length
+    /// \param idTab - id of tab be interacted with
+    /// \param graph - array of graph values
+    /// \param timestamps - sorted timestamps of each value, e.g. nanoseconds
+    /// \param color - item color
+    /// \param name - item name
+    /// \return - id, if id > 0, then id of created graph, else if id == -1, then graph isn't create
+    ///
+    int addGraph(int idTab, std::vector<type> &graph, const std::vector<qint64> &timestamps, QRgb color,
+                 QString name = "Graph");
+
+    ///
+    /// \brief addScatter - add cloud of points, e.g. parametric curve or XY plot. Cloud is drawn as points,
+    /// only part of it in view is drawn and dense parts are subsampled
+    /// \param idTab - id of tab be interacted with
+    /// \param x - coordinates X of points
+    /// \param y - coordinates Y of points, same number as X
+    /// \param color - item color
+    /// \param name - item name
+    /// \return - id, if id > 0, then id of created graph, else if id == -1, then graph isn't create
+    ///
+    int addScatter(int idTab, const std::vector<double> &x, const std::vector<double> &y, QRgb color,
+                   QString name = "Graph");
+
+    ///
+    /// \brief addWaterfall - add waterfall, e.g. spectrogram: rows of values over time drawn as intensity. Values
+    /// of row are spaced by step of graph along X, rows are stacked along Y with newest on top
+    /// \param idTab - id of tab be interacted with
+    /// \param width - number of values in row
+    /// \param rows - number of rows kept in history
+    /// \param name - item name
+    /// \return - id, if id > 0, then id of created graph, else if id == -1, then graph isn't create
+    ///
+    int addWaterfall(int idTab, size_t width, size_t rows, QString name = "Waterfall");
+
+    ///
+    /// \brief addGraphs - add several graphs to tab in one transaction, scene and legend are updated once
+    /// \param idTab - id of tab be interacted with
+    /// \param graphs - arrays of graph values
+    /// \param names - item names, missing names are "Graph"
+    /// \return - ids of created graphs, empty if graphs aren't create
+    ///
+    std::vector<int> addGraphs(int idTab, std::vector<std::vector<type>> &graphs, QStringList names = {});
+
+    ///
+    /// \brief addGraphFile - add graph backed by file, it isn't loaded in memory. Raw file (GraphFileHeader
+    /// and samples) gets levels of detail built in background, multi-resolution file (PyramidFileHeader) is shown
+    /// at once with stored levels
+    /// \param idTab - id of tab be interacted with
+    /// \param path - path of file
+    /// \param color - item color
+    /// \param name - item name
+    /// \return - id, if id > 0, then id of created graph, else if id == -1, then graph isn't create
+    ///
+    int addGraphFile(int idTab, const QString &path, QRgb color, QString name = "Graph");
+
     ///
     /// \brief addTab - add tab to widget
     /// \param name - item name
@@ -100,6 +211,17 @@ public:
     ///
     bool swapVHButtons(int idTab);
 
+    ///
+    /// \brief beginUpdate - start transaction, until its end changes of graphs in all tabs are only recorded and
+    /// scene, grid, legend and repaint are updated once at end, calls may be nested
+    ///
+    void beginUpdate();
+
+    ///
+    /// \brief endUpdate - end transaction started by beginUpdate
+    ///
+    void endUpdate();
+
     // --- Setters ---
 
     ///
@@ -195,6 +317,14 @@ public:
     ///
     bool setCancelSelectButton(int idTab, Qt::Key button);
 
+    ///
+    /// \brief setHudButton - set button which will show or hide performance overlay
+    /// \param idTab - id of tab be interacted with
+    /// \param button - button which will show or hide performance overlay
+    /// \return - true is all good, false is mistake
+    ///
+    bool setHudButton(int idTab, Qt::Key button);
+
     ///
     /// \brief setValuesGraph - set array of graph values
     /// \param idGraph - id of graph be interacted with
@@ -203,6 +333,113 @@ public:
     ///
     bool setValuesGraph(int idGraph, const std::vector<type> &graph);
 
+    ///
+    /// \brief setValuesGraph - set values of graph with own X
+    /// \param idGraph - id of graph be interacted with
+    /// \param graph - array of graph values
+    /// \param x - sorted X of each value
+    /// \return - true is all good, false is mistake
+    ///
+    bool setValuesGraph(int idGraph, const std::vector<type> &graph, const std::vector<double> &x);
+
+    ///
+    /// \brief setPointsGraph - set points of cloud added by addScatter
+    /// \param idGraph - id of graph be interacted with
+    /// \param x - coordinates X of points
+    /// \param y - coordinates Y of points, same number as X
+    /// \return - true is all good, false is mistake
+    ///
+    bool setPointsGraph(int idGraph, const std::vector<double> &x, const std::vector<double> &y);
+
+    ///
+    /// \brief addWaterfallRows - append rows to waterfall, only new rows are transferred to GPU
+    /// \param idGraph - id of graph be interacted with
+    /// \param rows - values of one or more rows one after another
+    /// \return - true is all good, false is mistake
+    ///
+    bool addWaterfallRows(int idGraph, const std::vector<float> &rows);
+
+    ///
+    /// \brief setWaterfallLevels - set values of waterfall shown by first and last colors of colormap
+    /// \param idGraph - id of graph be interacted with
+    /// \param low - value shown by first color
+    /// \param high - value shown by last color
+    /// \return - true is all good, false is mistake
+    ///
+    bool setWaterfallLevels(int idGraph, double low, double high);
+
+    ///
+    /// \brief setWaterfallColormap - set colormap of waterfall
+    /// \param idGraph - id of graph be interacted with
+    /// \param colors - colors evenly spaced from lowest to highest value, at least two
+    /// \return - true is all good, false is mistake
+    ///
+    bool setWaterfallColormap(int idGraph, const std::vector<QRgb> &colors);
+
+    ///
+    /// \brief setWaterfallRowStep - set distance between rows of waterfall along Y, e.g. period of spectra
+    /// \param idGraph - id of graph be interacted with
+    /// \param step - distance in scene measure
+    /// \return - true is all good, false is mistake
+    ///
+    bool setWaterfallRowStep(int idGraph, double step);
+
+    ///
+    /// \brief addSpectrum - add graph of spectrum of other graph, windowed FFT of its latest or visible samples.
+    /// Spectrum is computed in pool at most once per frame, when values or visible part of source are changed.
+    /// Only graphs with values in memory and evenly spaced samples can be source
+    /// \param idGraph - id of source graph
+    /// \param idTab - id of tab of spectrum
+    /// \param size - number of samples of transform, rounded up to power of 2
+    /// \param visible - whether to take visible samples of source, else latest samples
+    /// \param name - item name
+    /// \return - id, if id > 0, then id of created graph, else if id == -1, then graph isn't create
+    ///
+    int addSpectrum(int idGraph, int idTab, size_t size, bool visible = false, QString name = "Spectrum");
+
+    ///
+    /// \brief addDerived - add graph computed from other graph by transform. When source is changed, only part of
+    /// derived graph which depends on changed samples is recomputed. Chains of derived graphs are evaluated
+    /// together in pool. Source may be derived graph or graph with values in memory and evenly spaced samples
+    /// \param idGraph - id of source graph
+    /// \param idTab - id of tab of derived graph
+    /// \param transform - transform of source
+    /// \param parameter - parameter of transform, see DERIVED_TRANSFORM
+    /// \param offset - offset of scale transform
+    /// \param name - item name
+    /// \return - id, if id > 0, then id of created graph, else if id == -1, then graph isn't create
+    ///
+    int addDerived(int idGraph, int idTab, DERIVED_TRANSFORM transform, double parameter, double offset = 0,
+                   QString name = "Derived");
+
+    ///
+    /// \brief appendValuesGraph - append values to graph, derived graphs are recomputed only for appended values.
+    /// Graph must keep values in memory with evenly spaced samples; changes of each period are applied together and
+    /// graph is rebuilt whole
+    /// \param idGraph - id of graph be interacted with
+    /// \param values - appended values
+    /// \return - true is all good, false is mistake
+    ///
+    bool appendValuesGraph(int idGraph, const std::vector<type> &values);
+
+    ///
+    /// \brief updateValuesGraph - replace range of values of graph, graph is extended if range is beyond its end,
+    /// values between end and range are zeros. Graph must keep values in memory with evenly spaced samples
+    /// \param idGraph - id of graph be interacted with
+    /// \param first - index of first replaced value
+    /// \param values - new values
+    /// \return - true is all good, false is mistake
+    ///
+    bool updateValuesGraph(int idGraph, size_t first, const std::vector<type> &values);
+
+    ///
+    /// \brief setValuesGraphs - set values of several graphs in one transaction
+    /// \param idGraphs - ids of graphs be interacted with
+    /// \param graphs - arrays of graph values, one for each graph
+    /// \return - true is all good, false is mistake
+    ///
+    bool setValuesGraphs(const std::vector<int> &idGraphs, const std::vector<std::vector<type>> &graphs);
+
     ///
     /// \brief setNameGraph - set name of graph
     /// \param idGraph - id of graph be interacted with
@@ -219,6 +456,22 @@ public:
     ///
     bool setGraphVisible(int idGraph, bool show);
 
+    ///
+    /// \brief setGraphsVisible - whether to display graphs of tab which match filter of legend
+    /// \param idTab - id of tab be interacted with
+    /// \param show - whether to show items
+    /// \return - true is all good, false is mistake
+    ///
+    bool setGraphsVisible(int idTab, bool show);
+
+    ///
+    /// \brief setLegendFilter - show in legend of tab only graphs whose name contains filter
+    /// \param idTab - id of tab be interacted with
+    /// \param filter - part of graph name, case insensitive, empty shows all graphs
+    /// \return - true is all good, false is mistake
+    ///
+    bool setLegendFilter(int idTab, QString filter);
+
     ///
     /// \brief setGridVisible - whether to display grid in all tabs
     /// \param show - whether to show item
@@ -247,6 +500,204 @@ public:
     ///
     bool setGridCursorVisible(int idTab, bool show);
 
+    ///
+    /// \brief setHudVisible - whether to display performance overlay in all tabs
+    /// \param show - whether to show item
+    ///
+    void setHudVisible(bool show);
+
+    ///
+    /// \brief setHudVisible - whether to display performance overlay in tab
+    /// \param idTab - id of tab be interacted with
+    /// \param show - whether to show item
+    /// \return - true is all good, false is mistake
+    ///
+    bool setHudVisible(int idTab, bool show);
+
+    ///
+    /// \brief setReadoutVisible - whether to display values of samples nearest to cursor in all tabs
+    /// \param show - whether to show item
+    ///
+    void setReadoutVisible(bool show);
+
+    ///
+    /// \brief setReadoutVisible - whether to display values of samples of visible graphs nearest to cursor in tab
+    /// \param idTab - id of tab be interacted with
+    /// \param show - whether to show item
+    /// \return - true is all good, false is mistake
+    ///
+    bool setReadoutVisible(int idTab, bool show);
+
+    ///
+    /// \brief setCursorSnap - whether cursor grid snaps to nearest sample in all tabs
+    /// \param set - whether to snap
+    ///
+    void setCursorSnap(bool set);
+
+    ///
+    /// \brief setCursorSnap - whether cursor grid snaps to nearest sample of visible graphs near cursor in tab
+    /// \param idTab - id of tab be interacted with
+    /// \param set - whether to snap
+    /// \return - true is all good, false is mistake
+    ///
+    bool setCursorSnap(int idTab, bool set);
+
+    ///
+    /// \brief setPicking - whether click picks graph under cursor in all tabs
+    /// \param set - whether to pick
+    ///
+    void setPicking(bool set);
+
+    ///
+    /// \brief setPicking - whether click by zoom button without selection picks graph under cursor in tab, picked
+    /// graph is reported by signal graphPicked
+    /// \param idTab - id of tab be interacted with
+    /// \param set - whether to pick
+    /// \return - true is all good, false is mistake
+    ///
+    bool setPicking(int idTab, bool set);
+
+    ///
+    /// \brief setPickOnHover - whether graph under moving cursor is picked in all tabs
+    /// \param set - whether to pick
+    ///
+    void setPickOnHover(bool set);
+
+    ///
+    /// \brief setPickOnHover - whether graph under cursor is picked while mouse moves in tab, change of graph is
+    /// reported by signal graphHovered
+    /// \param idTab - id of tab be interacted with
+    /// \param set - whether to pick
+    /// \return - true is all good, false is mistake
+    ///
+    bool setPickOnHover(int idTab, bool set);
+
+    ///
+    /// \brief setFrameBudget - set budget of frame time in all tabs
+    /// \param ms - budget in milliseconds, 0 disables checking
+    ///
+    void setFrameBudget(double ms);
+
+    ///
+    /// \brief setFrameBudget - set budget of frame time in tab
+    /// \param idTab - id of tab be interacted with
+    /// \param ms - budget in milliseconds, 0 disables checking
+    /// \return - true is all good, false is mistake
+    ///
+    bool setFrameBudget(int idTab, double ms);
+
+    ///
+    /// \brief setRefineBudget - set budget of frame time for progressive rendering in all tabs
+    /// \param ms - budget in milliseconds, 0 disables progressive rendering
+    ///
+    void setRefineBudget(double ms);
+
+    ///
+    /// \brief setRefineBudget - set budget of frame time for progressive rendering in tab
+    /// \param idTab - id of tab be interacted with
+    /// \param ms - budget in milliseconds, 0 disables progressive rendering
+    /// \return - true is all good, false is mistake
+    ///
+    bool setRefineBudget(int idTab, double ms);
+
+    ///
+    /// \brief setQualityTarget - set target of frame time for quality governor in all tabs
+    /// \param ms - target in milliseconds, 0 disables governor
+    ///
+    void setQualityTarget(double ms);
+
+    ///
+    /// \brief setQualityTarget - set target of frame time for quality governor in tab
+    /// \param idTab - id of tab be interacted with
+    /// \param ms - target in milliseconds, 0 disables governor
+    /// \return - true is all good, false is mistake
+    ///
+    bool setQualityTarget(int idTab, double ms);
+
+    ///
+    /// \brief setAntialiasing - whether to draw graphs with antialiased lines in all tabs
+    /// \param set - whether to antialias lines
+    ///
+    void setAntialiasing(bool set);
+
+    ///
+    /// \brief setAntialiasing - whether to draw graphs with antialiased lines in tab
+    /// \param idTab - id of tab be interacted with
+    /// \param set - whether to antialias lines
+    /// \return - true is all good, false is mistake
+    ///
+    bool setAntialiasing(int idTab, bool set);
+
+    ///
+    /// \brief setDensityMode - whether to draw graphs as intensity in all tabs, hits of graphs in each pixel are
+    /// mapped through colormap
+    /// \param set - whether to draw intensity
+    ///
+    void setDensityMode(bool set);
+
+    ///
+    /// \brief setDensityMode - whether to draw graphs as intensity in tab
+    /// \param idTab - id of tab be interacted with
+    /// \param set - whether to draw intensity
+    /// \return - true is all good, false is mistake
+    ///
+    bool setDensityMode(int idTab, bool set);
+
+    ///
+    /// \brief setDensityDecay - set persistence of intensity in all tabs
+    /// \param decay - part of hits kept from previous frame, 0 shows only current frame
+    ///
+    void setDensityDecay(double decay);
+
+    ///
+    /// \brief setDensityDecay - set persistence of intensity in tab
+    /// \param idTab - id of tab be interacted with
+    /// \param decay - part of hits kept from previous frame, 0 shows only current frame
+    /// \return - true is all good, false is mistake
+    ///
+    bool setDensityDecay(int idTab, double decay);
+
+    ///
+    /// \brief setDensitySaturation - set number of hits of pixel shown by last color of colormap in tab
+    /// \param idTab - id of tab be interacted with
+    /// \param hits - number of hits
+    /// \return - true is all good, false is mistake
+    ///
+    bool setDensitySaturation(int idTab, double hits);
+
+    ///
+    /// \brief setDensityColormap - set colormap of intensity in tab
+    /// \param idTab - id of tab be interacted with
+    /// \param colors - colors evenly spaced from least to most hits, at least two
+    /// \return - true is all good, false is mistake
+    ///
+    bool setDensityColormap(int idTab, const std::vector<QRgb> &colors);
+
+    ///
+    /// \brief setMeasureMode - whether selection measures graphs instead of zooming in all tabs
+    /// \param set - whether to measure
+    ///
+    void setMeasureMode(bool set);
+
+    ///
+    /// \brief setMeasureMode - whether selection measures graphs instead of zooming in tab, statistics of graphs
+    /// in selected range are reported by signal rangeStatisticsUpdated
+    /// \param idTab - id of tab be interacted with
+    /// \param set - whether to measure
+    /// \return - true is all good, false is mistake
+    ///
+    bool setMeasureMode(int idTab, bool set);
+
+    ///
+    /// \brief measureRange - count statistics of graphs of tab in range of X, they are reported by signal
+    /// rangeStatisticsUpdated, cost doesn't depend on number of samples in range
+    /// \param idTab - id of tab be interacted with
+    /// \param begin - beginning of range
+    /// \param end - end of range
+    /// \return - true is all good, false is mistake
+    ///
+    bool measureRange(int idTab, double begin, double end);
+
     ///
     /// \brief setAxesName - set names of axes
     /// \param idTab - id of tab be interacted with
@@ -424,6 +875,12 @@ public:
     ///
     bool setWidthAxes(int idTab, float width);
 
+    ///
+    /// \brief setMemoryBudget - set budget of resident memory for each graph added from file
+    /// \param bytes - budget in bytes
+    ///
+    void setMemoryBudget(size_t bytes);
+
     // --- Getters ---
 
     ///
@@ -434,45 +891,216 @@ public:
 
     ///
     /// \brief getCurrentTab - get current tab
-    /// \return - current tab
+    /// \return - current tab, -1 if there are no tabs
     ///
     int getCurrentTab();
 
-private:
-
     ///
-    /// \brief updateGridValues - update grid and cursor grid values in tab
+    /// \brief getFrameStatistics - get rolling statistics (p50/p95/max) of each phase of frame in tab
     /// \param idTab - id of tab be interacted with
+    /// \return - statistics of frame phases, empty if tab doesn't exist
     ///
-    void updateGridValues(int idTab);
+    FrameStatistics getFrameStatistics(int idTab);
 
     ///
-    /// \brief convertColorName - convert QRgb in QString{"rgb(r, g, b)"}
-    /// \param color - item color
-    /// \return - conversion result, QString{"rgb(r, g, b)"}
+    /// \brief getQualityLevel - get quality level chosen by quality governor in tab
+    /// \param idTab - id of tab be interacted with
+    /// \return - quality level, 0 is full quality, -1 if tab doesn't exist
+    ///
+    int getQualityLevel(int idTab);
+
+    ///
+    /// \brief getRangeStatistics - get statistics (count, min, max, mean, RMS) of graphs in last measured range
+    /// \param idTab - id of tab be interacted with
+    /// \return - statistics of each graph with samples in range, empty if tab doesn't exist
+    ///
+    std::unordered_map<int, typename OGLW::RangeStatistics> getRangeStatistics(int idTab);
+
+    ///
+    /// \brief getMeasuredRange - get last measured range of X in tab
+    /// \param idTab - id of tab be interacted with
+    /// \return - pair of beginning and end of range
+    ///
+    std::pair<double, double> getMeasuredRange(int idTab);
+
+    ///
+    /// \brief getReadout - get samples of visible graphs nearest to cursor in tab, updated before signal
+    /// updateTextValues
+    /// \param idTab - id of tab be interacted with
+    /// \return - sample of each graph, empty if tab doesn't exist or readout and snap are disabled
+    ///
+    std::vector<typename OGLW::SampleReadout> getReadout(int idTab);
+
+    ///
+    /// \brief getPickedGraph - get graph picked by last click in tab
+    /// \param idTab - id of tab be interacted with
+    /// \return - id of graph, -1 if no graph is picked or tab doesn't exist
+    ///
+    int getPickedGraph(int idTab);
+
+    ///
+    /// \brief getHoveredGraph - get graph under cursor in tab
+    /// \param idTab - id of tab be interacted with
+    /// \return - id of graph, -1 if no graph is under cursor or tab doesn't exist
+    ///
+    int getHoveredGraph(int idTab);
+
+    ///
+    /// \brief pickGraph - find graph drawn nearest to point of tab, cost doesn't depend on number of graphs
+    /// \param idTab - id of tab be interacted with
+    /// \param point - point in plane of tab widget
+    /// \return - id of graph, -1 if no graph is near point or tab doesn't exist
+    ///
+    int pickGraph(int idTab, QPoint point);
+
+    // --- Tracing ---
+
+    ///
+    /// \brief setTracingEnabled - whether to record spans of ingest, scene updates, painting and signals
+    /// \param enabled - whether to record spans
+    ///
+    void setTracingEnabled(bool enabled);
+
+    ///
+    /// \brief dumpTrace - write recorded spans of all threads in Chrome trace JSON
+    /// \param path - path of file
+    /// \return - true is all good, false is mistake
+    ///
+    bool dumpTrace(const QString &path);
+
+private:
+
+    ///
+    /// \brief updateGridValues - update grid and cursor grid values in tab
+    /// \param idTab - id of tab be interacted with
+    ///
+    void updateGridValues(int idTab);
+
+    ///
+    /// \brief addGraphData - add graph to tab and legend
+    /// \param idTab - id of tab be interacted with
+    /// \param graphData - all data on graph, it's moved to widget
+    /// \param name - item name
+    /// \return - id of created graph
+    ///
+    int addGraphData(int idTab, typename OGLW::GraphData &graphData, QString name);
+
+    ///
+    /// \brief convertColorName - convert QRgb in QString{"rgb(r, g, b)"}
+    /// \param color - item color
+    /// \return - conversion result, QString{"rgb(r, g, b)"}
     ///
     QString convertColorName(QRgb color);
 
+    ///
+    /// \brief createSettingsDialog - create dialog of scene settings of tab, it's created on first use
+    /// \param idTab - id of tab be interacted with
+    ///
+    void createSettingsDialog(int idTab);
+
+    ///
+    /// \brief buildTab - create legend view, filter, axes and layouts of tab, they're created when tab is first shown
+    /// \param idWidget - tab id in QTabWidget
+    ///
+    void buildTab(int idWidget);
+
+    ///
+    /// \brief showSettingsDialog - fill dialog of scene settings with scene of tab and show it
+    /// \param idTab - id of tab be interacted with
+    ///
+    void showSettingsDialog(int idTab);
+
+    ///
+    /// \brief updateSuspendedTabs - suspend widgets of hidden tabs and resume widget of current tab
+    ///
+    void updateSuspendedTabs();
+
+    ///
+    /// \brief updateSpectra - start transforms of spectra whose source is changed and which aren't in pool
+    ///
+    void updateSpectra();
+
+    ///
+    /// \brief updateDerived - apply changes of values to series and evaluate chains of derived graphs whose
+    /// sources are changed
+    ///
+    void updateDerived();
+
+    ///
+    /// \brief publishDerived - set computed values of derived graph to its tab
+    /// \param idGraph - id of derived graph
+    ///
+    void publishDerived(int idGraph);
+
 private:
 
     // --- Helper structs ---
 
     ///
-    /// \brief The Graph class - store elements of legend
+    /// \brief The SettingsDialog struct - dialog of scene settings
+    ///
+    struct SettingsDialog {
+        QDialog                          *dialog{nullptr}; ///< Dialog, nullptr until first use
+        std::array<QDoubleSpinBox *, 4>            values; ///< Values of min X, max X, min Y, max Y
+        std::array<QSpinBox *, 4>               exponents; ///< Exponents of min X, max X, min Y, max Y
+    };
+
+    ///
+    /// \brief The Spectrum struct - derived graph of spectrum, buffers are allocated once and reused by transforms
+    ///
+    struct Spectrum {
+        int                     idSource; ///< Id of source graph
+        bool                     visible; ///< Whether visible samples are taken, else latest
+        SpectrumPlan                plan; ///< Transform with its window and work buffers
+        std::vector<type>          input; ///< Samples of source copied for transform
+        size_t               inputCount{0}; ///< Number of copied samples
+        std::vector<float>        levels; ///< Levels of bins in dB
+        std::vector<type>         output; ///< Levels converted to graph values
+        size_t    generation{SIZE_MAX}; ///< Version of source values of last transform
+        size_t         first{SIZE_MAX}; ///< First sample of source of last transform
+        bool                busy{false}; ///< Whether transform is in pool
+
+        Spectrum(int idSource, bool visible, size_t size)
+            : idSource{idSource}, visible{visible}, plan{size}
+        {
+            input.resize(plan.size());
+            levels.resize(plan.bins());
+            output.resize(plan.bins());
+        }
+    };
+
+    ///
+    /// \brief The Patch struct - change of values of series, applied when series isn't evaluated
     ///
-    struct Graph {
-        QPushButton *button; ///< Turn on/off graph
-        QLabel       *label; ///< Graph name
-        QRgb          color; ///< Graph color
-        bool           show; ///< Show or unshow graph
+    struct Patch {
+        size_t                     first; ///< Index of first changed value, SIZE_MAX is end of series
+        std::vector<type>         values; ///< New values
+        bool                     replace; ///< Whether values replace whole series
+    };
 
-        // --- Constructors/destructors ---
+    ///
+    /// \brief The Series struct - values of graph which is changed by ranges or is source of derived graphs.
+    /// Values are read by pool while chain is evaluated, changes wait until it's done
+    ///
+    struct Series {
+        std::vector<type>         values; ///< Values of graph
+        std::vector<Patch>       patches; ///< Changes not applied yet
+        std::vector<int>           chain; ///< Derived graphs in order of evaluation
+        bool              synced{false}; ///< Whether values are taken from widget
+        bool                busy{false}; ///< Whether chain is evaluated in pool
+    };
 
-        Graph() = default;
-        Graph(QPushButton *button, QLabel *label, QRgb color)
-            : button{button}, label{label}, color{color}, show{true}
-        {}
-        ~Graph() = default;
+    ///
+    /// \brief The Derived struct - graph computed from other graph
+    ///
+    struct Derived {
+        int                     idSource; ///< Id of source graph
+        int                       idRoot; ///< Id of graph at start of chain
+        std::shared_ptr<Derived>  parent; ///< Source if it's derived graph, else nullptr
+        size_t                    stride; ///< Number of samples of root per sample
+        DerivedSeries<type>       series; ///< Transform and computed values
+        size_t                  dirty{0}; ///< First sample of source recomputed regardless of changes of source
+        size_t          changed{SIZE_MAX}; ///< First changed value of last evaluation, SIZE_MAX is none
     };
 
     ///
@@ -480,21 +1108,23 @@ private:
     ///
     struct Tab {
         OGLW                      *OGLWidget; ///< Responsible for rendering
-        QHBoxLayout           *buttonsLayout; ///< Is legend
-        QWidget                       *XAxis; ///< Store labels on the X axis
-        QWidget                       *YAxis; ///< Store labels on the Y axis
+        LegendModel                  *legend; ///< Graphs of legend
+        QSortFilterProxyModel  *legendFilter; ///< Graphs of legend matching filter
+        QWidget                       *XAxis; ///< Store labels on the X axis, nullptr until tab is built
+        QWidget                       *YAxis; ///< Store labels on the Y axis, nullptr until tab is built
         int                         idWidget; ///< Tab id in QTabWidget
         bool                       deleteTab; ///< Is tab removed
+        bool                           built; ///< Are widgets of tab created
         std::pair<QString, QString> axesName; ///< Axes name in tab
         QRgb                       colorText; ///< Text color in tab
         QRgb                 colorBackCursor; ///< Cursor background color in tab
         QString                         font; ///< Font for text in tab
+        SettingsDialog              settings; ///< Dialog of scene settings
     };
 
     // --- Fields ---
 
     std::vector<Tab>               m_tabs; ///< Vector structures tab
-    std::vector<Graph>           m_graphs; ///< Vector structures graph
     std::vector<int>        m_graphsIdTab; ///< Vector stores tab numbers belonging to corresponding graphs
     QTabWidget               *m_tabWidget; ///< Responsible for tabs
     WidgetSignals                m_signal; ///< Emit signals
@@ -519,6 +1149,18 @@ private:
     float                     m_widthAxes; ///< Axes line width in tabs
 
     QString                        m_font; ///< Font for text in tabs
+
+    size_t                 m_memoryBudget; ///< Budget of resident memory for each graph added from file
+    TaskPool                   m_taskPool; ///< Builds levels of detail and extents of graphs of all tabs
+    std::shared_ptr<GpuBufferCache> m_bufferCache; ///< GPU buffers shared by all tabs
+    int                       m_updateDepth; ///< Number of open transactions
+
+    std::unordered_map<int, std::shared_ptr<Spectrum>> m_spectra; ///< Spectrum of each derived graph
+    QTimer                  m_spectrumTimer; ///< Throttles transforms of spectra to display rate
+
+    std::unordered_map<int, std::shared_ptr<Series>> m_series; ///< Series of graphs changed by ranges or sources
+    std::unordered_map<int, std::shared_ptr<Derived>> m_derived; ///< Derived graphs
+    QTimer                   m_derivedTimer; ///< Batches changes of series and evaluation of derived graphs
 };
 
 template<typename type, TYPE_VISIBLE T>
@@ -543,11 +1185,25 @@ MainWidget<type, T>::MainWidget(QWidget *parent)
     m_colorBackCursor = qRgb(230, 230, 230);
     m_widthGraph = m_widthGrid = m_widthGridCursor = m_widthAxes = 1;
     m_font = "'Arial'";
+    m_memoryBudget = MAPPED_MEMORY_BUDGET;
+    m_updateDepth = 0;
+    // Contexts of OpenGL widgets of one window are in one share group, so tabs use common buffers
+    m_bufferCache = std::make_shared<GpuBufferCache>();
 
     connect(&m_signal, &WidgetSignals::updateTextValues, this, [this](int id) {
         updateGridValues(id);
     });
-    connect(m_tabWidget, &QTabWidget::currentChanged, this, [this]([[maybe_unused]] int id) {
+    m_spectrumTimer.setInterval(SPECTRUM_UPDATE_MS);
+    connect(&m_spectrumTimer, &QTimer::timeout, this, [this]() {
+        updateSpectra();
+    });
+    m_derivedTimer.setInterval(DERIVED_UPDATE_MS);
+    connect(&m_derivedTimer, &QTimer::timeout, this, [this]() {
+        updateDerived();
+    });
+    connect(m_tabWidget, &QTabWidget::currentChanged, this, [this](int id) {
+        buildTab(id);
+        updateSuspendedTabs();
         m_signal.triggerSignalCurrentTab(getCurrentTab());
     });
 }
@@ -555,79 +1211,368 @@ MainWidget<type, T>::MainWidget(QWidget *parent)
 template<typename type, TYPE_VISIBLE T>
 int MainWidget<type, T>::addGraph(int idTab, std::vector<type> &graph, QString name)
 {
+    return addGraph(idTab, graph, m_colorGraph, name);
+}
+
+template<typename type, TYPE_VISIBLE T>
+int MainWidget<type, T>::addGraph(int idTab, std::vector<type> &graph, QRgb color, QString name)
+{
+    TRACE_SPAN("ingest addGraph");
+
     if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
         return -1;
 
-    int idGraph = m_graphsIdTab.size();
-    m_graphsIdTab.push_back(idTab);
+    typename OGLW::GraphData graphData{graph, color};
+
+    return addGraphData(idTab, graphData, name);
+}
 
-    typename OGLW::GraphData graphData{graph, m_colorGraph};
-    m_tabs[idTab].OGLWidget->addGraph(idGraph, graphData);
+template<typename type, TYPE_VISIBLE T>
+int MainWidget<type, T>::addGraph(int idTab, std::vector<type> &graph, const std::vector<double> &x, QRgb color,
+                                  QString name)
+{
+    TRACE_SPAN("ingest addGraph");
 
-    QPushButton *button = new QPushButton{};
-    button->setFixedSize(16, 16);
-    button->setStyleSheet(("background-color: " + convertColorName(m_colorGraph) + "; border: 1px solid black;"));
-    m_tabs[idTab].buttonsLayout->addWidget(button);
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab || graph.empty() || graph.size() != x.size()
+            || !std::is_sorted(x.begin(), x.end()))
+        return -1;
 
-    QLabel *label = new QLabel{name};
-    label->setFixedHeight(16);
-    label->setStyleSheet("color: " + convertColorName(m_colorText) + ";");
-    m_tabs[idTab].buttonsLayout->addWidget(label);
+    std::vector<double> relative(x.size());
+    for (size_t i = 0; i < x.size(); ++i)
+        relative[i] = x[i] - x[0];
 
-    m_graphs.push_back(Graph{button, label, m_colorGraph});
+    typename OGLW::GraphData graphData{graph, std::move(relative), x[0], color};
 
-    connect(button, &QPushButton::clicked, [this, idGraph]() {
-        Graph &g = m_graphs[idGraph];
+    return addGraphData(idTab, graphData, name);
+}
 
-        if (g.show)
-            g.button->setStyleSheet("background-color: white; border: 1px solid black;");
-        else
-            g.button->setStyleSheet(QString("background-color: " + convertColorName(g.color)
-                                            + "; border: 1px solid black;"));
+template<typename type, TYPE_VISIBLE T>
+int MainWidget<type, T>::addGraph(int idTab, std::vector<type> &graph, const std::vector<qint64> &timestamps,
+                                  QRgb color, QString name)
+{
+    TRACE_SPAN("ingest addGraph");
 
-        g.show ^= true;
-        setGraphVisible(idGraph, g.show);
-    });
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab || graph.empty() || graph.size() != timestamps.size()
+            || !std::is_sorted(timestamps.begin(), timestamps.end()))
+        return -1;
+
+    // Differences are exact in double, only starting point is rounded
+    std::vector<double> relative(timestamps.size());
+    for (size_t i = 0; i < timestamps.size(); ++i)
+        relative[i] = static_cast<double>(timestamps[i] - timestamps[0]);
+
+    typename OGLW::GraphData graphData{graph, std::move(relative), static_cast<double>(timestamps[0]), color};
+
+    return addGraphData(idTab, graphData, name);
+}
+
+template<typename type, TYPE_VISIBLE T>
+int MainWidget<type, T>::addScatter(int idTab, const std::vector<double> &x, const std::vector<double> &y, QRgb color,
+                                    QString name)
+{
+    TRACE_SPAN("ingest addScatter");
+
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab || x.empty() || x.size() != y.size())
+        return -1;
+
+    // Empty index marks graph as cloud until index of points is built
+    typename OGLW::GraphData graphData;
+    graphData.color = color;
+    graphData.scatter = std::make_shared<ScatterIndex>();
+
+    int idGraph = addGraphData(idTab, graphData, name);
+    m_tabs[idTab].OGLWidget->setPointsGraph(idGraph, x, y);
 
     return idGraph;
 }
 
 template<typename type, TYPE_VISIBLE T>
-int MainWidget<type, T>::addGraph(int idTab, std::vector<type> &graph, QRgb color, QString name)
+int MainWidget<type, T>::addSpectrum(int idGraph, int idTab, size_t size, bool visible, QString name)
 {
-    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+    if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1 || m_tabs.size() <= idTab
+            || m_tabs[idTab].deleteTab || size == 0)
         return -1;
 
-    int idGraph = m_graphsIdTab.size();
-    m_graphsIdTab.push_back(idTab);
+    // Samples are taken only from graphs with values in memory and evenly spaced samples
+    if (!m_tabs[m_graphsIdTab[idGraph]].OGLWidget->hasValuesGraph(idGraph))
+        return -1;
 
-    typename OGLW::GraphData graphData{graph, color};
-    m_tabs[idTab].OGLWidget->addGraph(idGraph, graphData);
+    auto spectrum = std::make_shared<Spectrum>(idGraph, visible, size);
 
-    QPushButton *button = new QPushButton{};
-    button->setFixedSize(16, 16);
-    button->setStyleSheet(("background-color: " + convertColorName(color) + "; border: 1px solid black;"));
-    m_tabs[idTab].buttonsLayout->addWidget(button);
+    // Graph is shown with floor levels until first transform
+    std::vector<type> levels(spectrum->plan.bins(), static_cast<type>(SPECTRUM_FLOOR_DB));
+    int idSpectrum = addGraph(idTab, levels, name);
+    if (idSpectrum == -1)
+        return -1;
 
-    QLabel *label = new QLabel{name};
-    label->setFixedHeight(16);
-    label->setStyleSheet("color: " + convertColorName(m_colorText) + "; font-family: " + m_tabs[idTab].font + ";");
-    m_tabs[idTab].buttonsLayout->addWidget(label);
+    m_spectra[idSpectrum] = std::move(spectrum);
+    if (!m_spectrumTimer.isActive())
+        m_spectrumTimer.start();
 
-    m_graphs.push_back(Graph{button, label, color});
+    return idSpectrum;
+}
 
-    connect(button, &QPushButton::clicked, [this, idGraph]() {
-        Graph &g = m_graphs[idGraph];
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::updateSpectra()
+{
+    for (auto &entry : m_spectra) {
+        int idSpectrum = entry.first;
+        std::shared_ptr<Spectrum> spectrum = entry.second;
+        int idTab = m_graphsIdTab[spectrum->idSource];
+        if (spectrum->busy || idTab == -1)
+            continue;
 
-        if (g.show)
-            g.button->setStyleSheet("background-color: white; border: 1px solid black;");
-        else
-            g.button->setStyleSheet(QString("background-color: " + convertColorName(g.color)
-                                            + "; border: 1px solid black;"));
+        // Samples are copied only if source is changed since last transform
+        size_t count = spectrum->input.size();
+        if (!m_tabs[idTab].OGLWidget->samplesGraph(spectrum->idSource, spectrum->visible, spectrum->generation,
+                                                   spectrum->first, spectrum->input.data(), count))
+            continue;
 
-        g.show ^= true;
-        setGraphVisible(idGraph, g.show);
-    });
+        spectrum->inputCount = count;
+        spectrum->busy = true;
+        m_taskPool.submit([this, idSpectrum, spectrum]() {
+            TRACE_SPAN("spectrum");
+
+            spectrum->plan.compute(spectrum->input.data(), spectrum->inputCount, spectrum->levels.data());
+            std::transform(spectrum->levels.begin(), spectrum->levels.end(), spectrum->output.begin(),
+                           [](float level) {
+                return static_cast<type>(level);
+            });
+
+            QMetaObject::invokeMethod(this, [this, idSpectrum, spectrum]() {
+                spectrum->busy = false;
+                if (m_spectra.count(idSpectrum))
+                    setValuesGraph(idSpectrum, spectrum->output);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+int MainWidget<type, T>::addDerived(int idGraph, int idTab, DERIVED_TRANSFORM transform, double parameter,
+                                    double offset, QString name)
+{
+    if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1 || m_tabs.size() <= idTab
+            || m_tabs[idTab].deleteTab)
+        return -1;
+
+    // Values of source are taken from widget, derived graphs are taken from their chains
+    if (!m_derived.count(idGraph) && !m_tabs[m_graphsIdTab[idGraph]].OGLWidget->hasValuesGraph(idGraph))
+        return -1;
+
+    auto node = std::make_shared<Derived>(Derived{idGraph, idGraph, nullptr, 1,
+                                                  DerivedSeries<type>{transform, parameter, offset}});
+    auto parent = m_derived.find(idGraph);
+    if (parent != m_derived.end()) {
+        node->idRoot = parent->second->idRoot;
+        node->parent = parent->second;
+        node->stride = parent->second->stride;
+    }
+    node->stride *= node->series.stride();
+
+    std::shared_ptr<Series> &series = m_series[node->idRoot];
+    if (!series)
+        series = std::make_shared<Series>();
+
+    typename OGLW::GraphData graphData;
+    graphData.color = m_colorGraph;
+    int idDerived = addGraphData(idTab, graphData, name);
+
+    // Parent is always evaluated before its children
+    series->chain.push_back(idDerived);
+    m_derived[idDerived] = std::move(node);
+    if (!m_derivedTimer.isActive())
+        m_derivedTimer.start();
+
+    return idDerived;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::updateDerived()
+{
+    for (auto &entry : m_series) {
+        int idRoot = entry.first;
+        std::shared_ptr<Series> series = entry.second;
+        int idTab = m_graphsIdTab[idRoot];
+        if (series->busy || idTab == -1)
+            continue;
+
+        // Graph replaced by other kind (e.g. by points or own X) has no values to change anymore
+        if (!m_tabs[idTab].OGLWidget->hasValuesGraph(idRoot)) {
+            series->patches.clear();
+            series->synced = false;
+            continue;
+        }
+
+        // Values are taken from widget once, until then changes wait
+        size_t from = SIZE_MAX;
+        if (!series->synced) {
+            if (!m_tabs[idTab].OGLWidget->getValuesGraph(idRoot, series->values))
+                continue;
+            series->synced = true;
+            from = 0;
+        }
+
+        std::vector<type> &values = series->values;
+        for (Patch &patch : series->patches) {
+            if (patch.replace) {
+                // Only values after common beginning are changed
+                size_t common = std::min(values.size(), patch.values.size());
+                size_t same = std::mismatch(values.begin(), values.begin() + common, patch.values.begin()).first
+                        - values.begin();
+                if (same < common || values.size() != patch.values.size())
+                    from = std::min(from, same);
+                values = std::move(patch.values);
+                continue;
+            }
+
+            // Gap before range beyond end is filled by zeros, it's changed too
+            size_t first = patch.first == SIZE_MAX ? values.size() : patch.first;
+            from = std::min(from, std::min(first, values.size()));
+            if (values.size() < first + patch.values.size())
+                values.resize(first + patch.values.size());
+            std::copy(patch.values.begin(), patch.values.end(), values.begin() + first);
+        }
+        // Root is sent whole, so its levels of detail and buffer are rebuilt for each batch of changes
+        if (!series->patches.empty() && from != SIZE_MAX)
+            m_tabs[idTab].OGLWidget->setValuesGraph(idRoot, values);
+        series->patches.clear();
+
+        // Chain is taken by value, graphs added or deleted meanwhile don't affect evaluation
+        std::vector<std::shared_ptr<Derived>> chain;
+        bool dirty = from != SIZE_MAX;
+        for (int idDerived : series->chain) {
+            chain.push_back(m_derived[idDerived]);
+            dirty = dirty || chain.back()->dirty != SIZE_MAX;
+        }
+        if (!dirty || chain.empty())
+            continue;
+
+        series->busy = true;
+        m_taskPool.submit([this, series, chain, from]() {
+            TRACE_SPAN("derived");
+
+            for (const auto &node : chain) {
+                size_t changed = node->parent ? node->parent->changed : from;
+                const std::vector<type> &input = node->parent ? node->parent->series.output() : series->values;
+                size_t first = std::min(changed, node->dirty);
+                node->dirty = SIZE_MAX;
+                node->changed = first == SIZE_MAX ? SIZE_MAX : node->series.update(input.data(), input.size(), first);
+            }
+
+            QMetaObject::invokeMethod(this, [this, series, chain]() {
+                series->busy = false;
+                for (const auto &node : chain) {
+                    if (node->changed == SIZE_MAX)
+                        continue;
+                    for (const auto &derived : m_derived)
+                        if (derived.second == node)
+                            publishDerived(derived.first);
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::publishDerived(int idGraph)
+{
+    const Derived &node = *m_derived[idGraph];
+    int idTab = m_graphsIdTab[idGraph];
+    int idRootTab = m_graphsIdTab[node.idRoot];
+    if (idTab == -1 || idRootTab == -1)
+        return;
+
+    // Derived graph starts with its root, resampled graph has own X spaced by its stride
+    OGLW *widget = m_tabs[idTab].OGLWidget;
+    widget->setStartPointGraph(idGraph, m_tabs[idRootTab].OGLWidget->getStartPointGraph(node.idRoot));
+    if (node.stride == 1) {
+        widget->setValuesGraph(idGraph, node.series.output());
+        return;
+    }
+
+    double step = node.stride * m_tabs[idRootTab].OGLWidget->getStepGraph();
+    std::vector<double> x(node.series.output().size());
+    for (size_t i = 0; i < x.size(); ++i)
+        x[i] = i * step;
+    widget->setValuesGraph(idGraph, node.series.output(), x);
+}
+
+template<typename type, TYPE_VISIBLE T>
+int MainWidget<type, T>::addWaterfall(int idTab, size_t width, size_t rows, QString name)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab || width == 0 || rows == 0)
+        return -1;
+
+    typename OGLW::GraphData graphData;
+    graphData.color = m_colorGraph;
+    graphData.waterfall = std::make_shared<Waterfall>(width, rows);
+
+    return addGraphData(idTab, graphData, name);
+}
+
+template<typename type, TYPE_VISIBLE T>
+std::vector<int> MainWidget<type, T>::addGraphs(int idTab, std::vector<std::vector<type>> &graphs, QStringList names)
+{
+    TRACE_SPAN("ingest addGraphs");
+
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return {};
+
+    UpdateGuard guard{*this};
+
+    std::vector<int> idGraphs;
+    idGraphs.reserve(graphs.size());
+    for (size_t i = 0; i < graphs.size(); ++i)
+        idGraphs.push_back(addGraph(idTab, graphs[i], m_colorGraph, i < names.size() ? names[i] : "Graph"));
+
+    return idGraphs;
+}
+
+template<typename type, TYPE_VISIBLE T>
+int MainWidget<type, T>::addGraphFile(int idTab, const QString &path, QRgb color, QString name)
+{
+    TRACE_SPAN("ingest addGraphFile");
+
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return -1;
+
+    QFile file{path};
+    quint32 magic{};
+    if (!file.open(QIODevice::ReadOnly) || file.read(reinterpret_cast<char *>(&magic), sizeof(magic)) != sizeof(magic))
+        return -1;
+    file.close();
+
+    std::shared_ptr<GraphSource<type>> source;
+    if (magic == PYRAMID_FILE_MAGIC) {
+        auto pyramidSource = std::make_shared<PyramidFileSource<type>>();
+        pyramidSource->setMemoryBudget(m_memoryBudget);
+        if (!pyramidSource->open(path))
+            return -1;
+        source = pyramidSource;
+    } else {
+        auto mappedSource = std::make_shared<MappedGraphSource<type>>();
+        mappedSource->setMemoryBudget(m_memoryBudget);
+        if (!mappedSource->open(path))
+            return -1;
+        source = mappedSource;
+    }
+
+    typename OGLW::GraphData graphData{source, color};
+
+    return addGraphData(idTab, graphData, name);
+}
+
+template<typename type, TYPE_VISIBLE T>
+int MainWidget<type, T>::addGraphData(int idTab, typename OGLW::GraphData &graphData, QString name)
+{
+    int idGraph = m_graphsIdTab.size();
+    m_graphsIdTab.push_back(idTab);
+
+    QRgb color = graphData.color;
+    m_tabs[idTab].OGLWidget->addGraph(idGraph, std::move(graphData));
+
+    m_tabs[idTab].legend->addGraph(idGraph, name, color);
 
     return idGraph;
 }
@@ -636,23 +1581,18 @@ template<typename type, TYPE_VISIBLE T>
 int MainWidget<type, T>::addTab(QString name)
 {
     QWidget *tab = new QWidget();
-    QVBoxLayout *mainL = new QVBoxLayout();
-    QVBoxLayout *GLWAxis = new QVBoxLayout();
-    QHBoxLayout *GLWBut = new QHBoxLayout();
-    QHBoxLayout *topLayout = new QHBoxLayout();
-    QHBoxLayout *buttonsLayout = new QHBoxLayout();
-    QWidget *XAxis = new QWidget();
-    QWidget *YAxis = new QWidget();
 
     int idTab = m_tabs.size();
     tab->setStyleSheet("background-color: " + convertColorName(m_colorBack) + ";");
 
     m_tabs.push_back(Tab{});
     m_tabs[idTab].OGLWidget = new OGLW{idTab};
-    m_tabs[idTab].buttonsLayout = buttonsLayout;
-    m_tabs[idTab].XAxis = XAxis;
-    m_tabs[idTab].YAxis = YAxis;
+    m_tabs[idTab].legend = new LegendModel{tab};
+    m_tabs[idTab].legendFilter = new QSortFilterProxyModel{tab};
+    m_tabs[idTab].XAxis = nullptr;
+    m_tabs[idTab].YAxis = nullptr;
     m_tabs[idTab].deleteTab = false;
+    m_tabs[idTab].built = false;
     m_tabs[idTab].idWidget = m_tabWidget->count();
     m_tabs[idTab].axesName = {"X", "Y"};
     m_tabs[idTab].colorText = m_colorText;
@@ -663,6 +1603,8 @@ int MainWidget<type, T>::addTab(QString name)
     m_tabs[idTab].OGLWidget->setStepGrid(m_stepGrid);
     m_tabs[idTab].OGLWidget->setUpdateSceneAuto(m_updateSceneAuto);
     m_tabs[idTab].OGLWidget->setSignal(&m_signal);
+    m_tabs[idTab].OGLWidget->setTaskPool(&m_taskPool);
+    m_tabs[idTab].OGLWidget->setBufferCache(m_bufferCache);
     m_tabs[idTab].OGLWidget->setColorBack(m_colorBack);
     m_tabs[idTab].OGLWidget->setColorGrid(m_colorGrid);
     m_tabs[idTab].OGLWidget->setColorGridCursor(m_colorGridCursor);
@@ -672,6 +1614,95 @@ int MainWidget<type, T>::addTab(QString name)
     m_tabs[idTab].OGLWidget->setWidthGridCursor(m_widthGridCursor);
     m_tabs[idTab].OGLWidget->setWidthAxes(m_widthAxes);
 
+    // Widget is owned by tab before it's laid out, so it's removed together with tab that was never shown
+    m_tabs[idTab].OGLWidget->setParent(tab);
+
+    // Tab is suspended until it becomes current
+    m_tabs[idTab].OGLWidget->setSuspended(m_tabWidget->count() > 0);
+    for (int i = 0; i < m_updateDepth; ++i)
+        m_tabs[idTab].OGLWidget->beginUpdate();
+
+    m_tabs[idTab].legend->setColorText(m_colorText);
+    m_tabs[idTab].legend->setFontText(m_font);
+    m_tabs[idTab].legend->setVisibleCallback([this, idTab](int idGraph, bool show) {
+        m_tabs[idTab].OGLWidget->setGraphVisible(idGraph, show);
+    });
+    m_tabs[idTab].legendFilter->setSourceModel(m_tabs[idTab].legend);
+    m_tabs[idTab].legendFilter->setFilterCaseSensitivity(Qt::CaseInsensitive);
+
+    // First tab becomes current here and is built at once, others are built when they're first shown
+    m_tabWidget->addTab(tab, name);
+
+    return idTab;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::buildTab(int idWidget)
+{
+    auto found = std::find_if(m_tabs.begin(), m_tabs.end(), [idWidget](const Tab & tab) {
+        return !tab.deleteTab && tab.idWidget == idWidget;
+    });
+    if (found == m_tabs.end() || found->built)
+        return;
+
+    TRACE_SPAN("buildTab");
+
+    int idTab = found - m_tabs.begin();
+    QWidget *tab = m_tabWidget->widget(idWidget);
+    QVBoxLayout *mainL = new QVBoxLayout();
+    QVBoxLayout *GLWAxis = new QVBoxLayout();
+    QHBoxLayout *GLWBut = new QHBoxLayout();
+    QHBoxLayout *topLayout = new QHBoxLayout();
+    QVBoxLayout *legendLayout = new QVBoxLayout();
+    QHBoxLayout *filterLayout = new QHBoxLayout();
+    QWidget *XAxis = new QWidget();
+    QWidget *YAxis = new QWidget();
+
+    m_tabs[idTab].XAxis = XAxis;
+    m_tabs[idTab].YAxis = YAxis;
+    m_tabs[idTab].built = true;
+
+    // View creates items only for rows in its viewport, rows have equal size so they are laid out without measuring
+    QListView *legendView = new QListView();
+    legendView->setModel(m_tabs[idTab].legendFilter);
+    legendView->setFlow(QListView::LeftToRight);
+    legendView->setWrapping(true);
+    legendView->setResizeMode(QListView::Adjust);
+    legendView->setUniformItemSizes(true);
+    legendView->setLayoutMode(QListView::Batched);
+    legendView->setSelectionMode(QAbstractItemView::NoSelection);
+    legendView->setIconSize({16, 16});
+    legendView->setFrameShape(QFrame::NoFrame);
+
+    QLineEdit *filterEdit = new QLineEdit();
+    filterEdit->setPlaceholderText("Filter");
+    filterEdit->setClearButtonEnabled(true);
+    QObject::connect(filterEdit, &QLineEdit::textChanged, [ = ](const QString &filter) {
+        setLegendFilter(idTab, filter);
+    });
+
+    QPushButton *showButton = new QPushButton();
+    showButton->setIcon(style()->standardIcon(QStyle::SP_DialogYesButton));
+    showButton->setToolTip("Show filtered graphs");
+    showButton->setFixedWidth(30);
+    QObject::connect(showButton, &QPushButton::clicked, [ = ]() {
+        setGraphsVisible(idTab, true);
+    });
+
+    QPushButton *hideButton = new QPushButton();
+    hideButton->setIcon(style()->standardIcon(QStyle::SP_DialogNoButton));
+    hideButton->setToolTip("Hide filtered graphs");
+    hideButton->setFixedWidth(30);
+    QObject::connect(hideButton, &QPushButton::clicked, [ = ]() {
+        setGraphsVisible(idTab, false);
+    });
+
+    filterLayout->addWidget(filterEdit, 20);
+    filterLayout->addWidget(showButton, 1);
+    filterLayout->addWidget(hideButton, 1);
+    legendLayout->addLayout(filterLayout);
+    legendLayout->addWidget(legendView);
+
     QPushButton *settingsButton = new QPushButton();
     settingsButton->setIcon(style()->standardIcon(QStyle::SP_MessageBoxInformation));
     settingsButton->setFixedWidth(30);
@@ -688,13 +1719,39 @@ int MainWidget<type, T>::addTab(QString name)
         background: rgba(0, 0, 0, 0.12);
     })");
 
-    QDialog *settingsDialog = new QDialog(this);
-    settingsDialog->setWindowTitle("Настройки");
-    settingsDialog->setWindowIcon(style()->standardIcon(QStyle::SP_MessageBoxInformation));
-    settingsDialog->setFixedSize(250, 250);
+    QObject::connect(settingsButton, &QPushButton::clicked, [ = ]() {
+        showSettingsDialog(idTab);
+    });
 
-    auto makeDoubleSpin = [&]() {
-        QDoubleSpinBox *s = new QDoubleSpinBox(settingsDialog);
+    GLWAxis->addWidget(m_tabs[idTab].OGLWidget, 20);
+    GLWAxis->addWidget(XAxis, 1);
+
+    YAxis->setMinimumWidth(35);
+    GLWBut->addWidget(YAxis, 1);
+    GLWBut->addLayout(GLWAxis, 20);
+
+    topLayout->addLayout(legendLayout, 20);
+    topLayout->addWidget(settingsButton, 1);
+
+    mainL->addLayout(topLayout, 1);
+    mainL->addSpacing(10);
+    mainL->addLayout(GLWBut, 10);
+
+    tab->setLayout(mainL);
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::createSettingsDialog(int idTab)
+{
+    TRACE_SPAN("createSettingsDialog");
+
+    QDialog *settingsDialog = new QDialog(this);
+    settingsDialog->setWindowTitle("Настройки");
+    settingsDialog->setWindowIcon(style()->standardIcon(QStyle::SP_MessageBoxInformation));
+    settingsDialog->setFixedSize(250, 250);
+
+    auto makeDoubleSpin = [&]() {
+        QDoubleSpinBox *s = new QDoubleSpinBox(settingsDialog);
         s->setRange(SPIN_GLOB_MIN, SPIN_GLOB_MAX);
         s->setSingleStep(1);
         s->setDecimals(SPIN_DECIMALS);
@@ -746,32 +1803,6 @@ int MainWidget<type, T>::addTab(QString name)
 
     settingsDialog->setLayout(dialogLayout);
 
-    auto splitValue = [](double val, QDoubleSpinBox * valueSpin, QSpinBox * expSpin) {
-        if (val == 0.0) {
-            valueSpin->setValue(0.0);
-            expSpin->setValue(0);
-            return;
-        }
-
-        int exp = static_cast<int>(std::floor(std::log10(std::fabs(val))));
-        double scale = std::pow(10.0, SPIN_DECIMALS);
-        double value = std::round(val / std::pow(10.0, exp) * scale) / scale;
-        expSpin->setValue(exp);
-        valueSpin->setValue(value);
-    };
-
-    QObject::connect(settingsButton, &QPushButton::clicked, [ = ]() {
-        auto minMaxX = m_tabs[idTab].OGLWidget->getMinMaxXScene();
-        auto minMaxY = m_tabs[idTab].OGLWidget->getMinMaxYScene();
-
-        splitValue(minMaxX.first, spinMinX, expMinX);
-        splitValue(minMaxX.second, spinMaxX, expMaxX);
-        splitValue(minMaxY.first, spinMinY, expMinY);
-        splitValue(minMaxY.second, spinMaxY, expMaxY);
-
-        settingsDialog->exec();
-    });
-
     auto computeValue = [](double value, int exp) -> double {
         return value * std::pow(10.0, exp);
     };
@@ -834,180 +1865,624 @@ int MainWidget<type, T>::addTab(QString name)
         updateY();
     });
 
-    GLWAxis->addWidget(m_tabs[idTab].OGLWidget, 20);
-    GLWAxis->addWidget(XAxis, 1);
+    m_tabs[idTab].settings = SettingsDialog{settingsDialog, {spinMinX, spinMaxX, spinMinY, spinMaxY},
+        {expMinX, expMaxX, expMinY, expMaxY}};
+}
 
-    YAxis->setMinimumWidth(35);
-    GLWBut->addWidget(YAxis, 1);
-    GLWBut->addLayout(GLWAxis, 20);
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::showSettingsDialog(int idTab)
+{
+    if (!m_tabs[idTab].settings.dialog)
+        createSettingsDialog(idTab);
 
-    topLayout->addLayout(buttonsLayout, 20);
-    topLayout->addWidget(settingsButton, 1);
+    auto splitValue = [](double val, QDoubleSpinBox * valueSpin, QSpinBox * expSpin) {
+        if (val == 0.0) {
+            valueSpin->setValue(0.0);
+            expSpin->setValue(0);
+            return;
+        }
 
-    mainL->addLayout(topLayout, 1);
-    mainL->addSpacing(10);
-    mainL->addLayout(GLWBut, 10);
+        int exp = static_cast<int>(std::floor(std::log10(std::fabs(val))));
+        double scale = std::pow(10.0, SPIN_DECIMALS);
+        double value = std::round(val / std::pow(10.0, exp) * scale) / scale;
+        expSpin->setValue(exp);
+        valueSpin->setValue(value);
+    };
 
-    tab->setLayout(mainL);
-    m_tabWidget->addTab(tab, name);
+    const SettingsDialog &settings = m_tabs[idTab].settings;
+    auto minMaxX = m_tabs[idTab].OGLWidget->getMinMaxXScene();
+    auto minMaxY = m_tabs[idTab].OGLWidget->getMinMaxYScene();
+
+    splitValue(minMaxX.first, settings.values[0], settings.exponents[0]);
+    splitValue(minMaxX.second, settings.values[1], settings.exponents[1]);
+    splitValue(minMaxY.first, settings.values[2], settings.exponents[2]);
+    splitValue(minMaxY.second, settings.values[3], settings.exponents[3]);
+
+    settings.dialog->exec();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::updateSuspendedTabs()
+{
+    int current = getCurrentTab();
+    for (size_t i = 0; i < m_tabs.size(); ++i) {
+        if (m_tabs[i].deleteTab)
+            continue;
+
+        m_tabs[i].OGLWidget->setSuspended(static_cast<int>(i) != current);
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::deleteTab(int idTab)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].deleteTab = true;
+
+    for (auto &graphIdTab : m_graphsIdTab)
+        if (graphIdTab == idTab)
+            graphIdTab = -1;
+
+    // Spectra and derived graphs of tab or of graphs of tab aren't evaluated anymore
+    for (auto spectrum = m_spectra.begin(); spectrum != m_spectra.end();) {
+        if (m_graphsIdTab[spectrum->first] == -1 || m_graphsIdTab[spectrum->second->idSource] == -1)
+            spectrum = m_spectra.erase(spectrum);
+        else
+            ++spectrum;
+    }
+    if (m_spectra.empty())
+        m_spectrumTimer.stop();
+    for (auto derived = m_derived.begin(); derived != m_derived.end();) {
+        auto series = m_series.find(derived->second->idRoot);
+        if (m_graphsIdTab[derived->first] != -1) {
+            ++derived;
+            continue;
+        }
+        if (series != m_series.end()) {
+            auto &chain = series->second->chain;
+            chain.erase(std::remove(chain.begin(), chain.end(), derived->first), chain.end());
+        }
+        derived = m_derived.erase(derived);
+    }
+    for (auto series = m_series.begin(); series != m_series.end();) {
+        if (m_graphsIdTab[series->first] == -1)
+            series = m_series.erase(series);
+        else
+            ++series;
+    }
+    if (m_series.empty())
+        m_derivedTimer.stop();
+
+    // Ids are shifted before removing, because removing emits currentChanged with id of tab shown instead
+    for (int i = idTab + 1; i < m_tabs.size(); ++i) {
+        if (m_tabs[i].deleteTab)
+            continue;
+
+        --m_tabs[i].idWidget;
+    }
+
+    QWidget *widget = m_tabWidget->widget(m_tabs[idTab].idWidget);
+    m_tabWidget->removeTab(m_tabs[idTab].idWidget);
+    widget->deleteLater();
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::beginUpdate()
+{
+    // Legend and layouts aren't relaid out for each added graph
+    if (m_updateDepth++ == 0)
+        setUpdatesEnabled(false);
+
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
+            continue;
+
+        tab.OGLWidget->beginUpdate();
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::endUpdate()
+{
+    if (m_updateDepth == 0)
+        return;
+
+    TRACE_SPAN("endUpdate");
+
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
+            continue;
+
+        tab.OGLWidget->endUpdate();
+    }
+
+    if (--m_updateDepth == 0)
+        setUpdatesEnabled(true);
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::deleteGraph(int idGraph)
+{
+    if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1)
+        return false;
+
+    m_tabs[m_graphsIdTab[idGraph]].OGLWidget->deleteGraph(idGraph);
+    m_tabs[m_graphsIdTab[idGraph]].legend->deleteGraph(idGraph);
+    m_graphsIdTab[idGraph] = -1;
+
+    // Spectra of graph are deleted with it
+    m_spectra.erase(idGraph);
+    std::vector<int> spectra;
+    for (const auto &spectrum : m_spectra)
+        if (spectrum.second->idSource == idGraph)
+            spectra.push_back(spectrum.first);
+    for (int idSpectrum : spectra)
+        deleteGraph(idSpectrum);
+    if (m_spectra.empty())
+        m_spectrumTimer.stop();
+
+    // Derived graphs of graph are deleted with it, evaluation in pool keeps its own references
+    auto derived = m_derived.find(idGraph);
+    if (derived != m_derived.end()) {
+        auto series = m_series.find(derived->second->idRoot);
+        if (series != m_series.end()) {
+            auto &chain = series->second->chain;
+            chain.erase(std::remove(chain.begin(), chain.end(), idGraph), chain.end());
+        }
+        m_derived.erase(derived);
+    }
+    m_series.erase(idGraph);
+    std::vector<int> children;
+    for (const auto &child : m_derived)
+        if (child.second->idSource == idGraph)
+            children.push_back(child.first);
+    for (int idChild : children)
+        deleteGraph(idChild);
+    if (m_series.empty())
+        m_derivedTimer.stop();
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::updateScene(int idTab)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].OGLWidget->updateScene();
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::swapMouseButton(int idTab)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].OGLWidget->swapMouseButton();
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setTabsWidgetPos(QTabWidget::TabPosition pos)
+{
+    m_tabWidget->setTabPosition(pos);
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setCurrentTab(int idTab)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    int id{};
+    for (int i = 0; i < idTab; ++i) {
+        if (!m_tabs[i].deleteTab)
+            ++id;
+    }
+
+    m_tabWidget->setCurrentIndex(id);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setUpdateSceneAuto(bool set)
+{
+    m_updateSceneAuto = set;
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
+            continue;
+
+        tab.OGLWidget->setUpdateSceneAuto(set);
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setGraphVisible(int idGraph, bool show)
+{
+    if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1)
+        return false;
+
+    m_tabs[m_graphsIdTab[idGraph]].OGLWidget->setGraphVisible(idGraph, show);
+    m_tabs[m_graphsIdTab[idGraph]].legend->setGraphVisible(idGraph, show);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setGraphsVisible(int idTab, bool show)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    QSortFilterProxyModel *filter = m_tabs[idTab].legendFilter;
+
+    std::vector<int> rows;
+    rows.reserve(filter->rowCount());
+    for (int i = 0; i < filter->rowCount(); ++i)
+        rows.push_back(filter->mapToSource(filter->index(i, 0)).row());
+
+    m_tabs[idTab].legend->setRowsVisible(rows, show);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setLegendFilter(int idTab, QString filter)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].legendFilter->setFilterFixedString(filter);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setGridVisible(bool show)
+{
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
+            continue;
+
+        tab.OGLWidget->setGridVisible(show);
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setGridVisible(int idTab, bool show)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].OGLWidget->setGridVisible(show);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setGridCursorVisible(bool show)
+{
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
+            continue;
+
+        tab.OGLWidget->setGridCursorVisible(show);
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setGridCursorVisible(int idTab, bool show)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].OGLWidget->setGridCursorVisible(show);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setHudVisible(bool show)
+{
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
+            continue;
+
+        tab.OGLWidget->setHudVisible(show);
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setHudVisible(int idTab, bool show)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].OGLWidget->setHudVisible(show);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setReadoutVisible(bool show)
+{
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
+            continue;
+
+        tab.OGLWidget->setReadoutVisible(show);
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setReadoutVisible(int idTab, bool show)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].OGLWidget->setReadoutVisible(show);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setCursorSnap(bool set)
+{
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
+            continue;
+
+        tab.OGLWidget->setCursorSnap(set);
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setCursorSnap(int idTab, bool set)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].OGLWidget->setCursorSnap(set);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setPicking(bool set)
+{
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
+            continue;
+
+        tab.OGLWidget->setPicking(set);
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setPicking(int idTab, bool set)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].OGLWidget->setPicking(set);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setPickOnHover(bool set)
+{
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
+            continue;
+
+        tab.OGLWidget->setPickOnHover(set);
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setPickOnHover(int idTab, bool set)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].OGLWidget->setPickOnHover(set);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setFrameBudget(double ms)
+{
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
+            continue;
 
-    return idTab;
+        tab.OGLWidget->setFrameBudget(ms);
+    }
 }
 
 template<typename type, TYPE_VISIBLE T>
-bool MainWidget<type, T>::deleteTab(int idTab)
+bool MainWidget<type, T>::setFrameBudget(int idTab, double ms)
 {
     if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
         return false;
 
-    m_tabs[idTab].deleteTab = true;
-    QWidget *widget = m_tabWidget->widget(m_tabs[idTab].idWidget);
-    m_tabWidget->removeTab(m_tabs[idTab].idWidget);
-    widget->deleteLater();
+    m_tabs[idTab].OGLWidget->setFrameBudget(ms);
 
-    for (auto &graphIdTab : m_graphsIdTab)
-        if (graphIdTab == idTab)
-            graphIdTab = -1;
+    return true;
+}
 
-    for (int i = idTab + 1; i < m_tabs.size(); ++i) {
-        if (m_tabs[i].deleteTab)
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setRefineBudget(double ms)
+{
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
             continue;
 
-        --m_tabs[i].idWidget;
+        tab.OGLWidget->setRefineBudget(ms);
     }
-
-    return true;
 }
 
 template<typename type, TYPE_VISIBLE T>
-bool MainWidget<type, T>::deleteGraph(int idGraph)
+bool MainWidget<type, T>::setRefineBudget(int idTab, double ms)
 {
-    if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1)
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
         return false;
 
-    m_tabs[m_graphsIdTab[idGraph]].OGLWidget->deleteGraph(idGraph);
-    m_tabs[m_graphsIdTab[idGraph]].graphs[idGraph].button->deleteLater();
-    m_tabs[m_graphsIdTab[idGraph]].graphs[idGraph].label->deleteLater();
-    m_graphsIdTab[idGraph] = -1;
+    m_tabs[idTab].OGLWidget->setRefineBudget(ms);
 
     return true;
 }
 
 template<typename type, TYPE_VISIBLE T>
-bool MainWidget<type, T>::updateScene(int idTab)
+void MainWidget<type, T>::setQualityTarget(double ms)
 {
-    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
-        return false;
-
-    m_tabs[idTab].OGLWidget->updateScene();
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
+            continue;
 
-    return true;
+        tab.OGLWidget->setQualityTarget(ms);
+    }
 }
 
 template<typename type, TYPE_VISIBLE T>
-bool MainWidget<type, T>::swapMouseButton(int idTab)
+bool MainWidget<type, T>::setQualityTarget(int idTab, double ms)
 {
     if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
         return false;
 
-    m_tabs[idTab].OGLWidget->swapMouseButton();
+    m_tabs[idTab].OGLWidget->setQualityTarget(ms);
 
     return true;
 }
 
 template<typename type, TYPE_VISIBLE T>
-void MainWidget<type, T>::setTabsWidgetPos(QTabWidget::TabPosition pos)
+void MainWidget<type, T>::setAntialiasing(bool set)
 {
-    m_tabWidget->setTabPosition(pos);
+    for (auto &tab : m_tabs) {
+        if (tab.deleteTab)
+            continue;
+
+        tab.OGLWidget->setAntialiasing(set);
+    }
 }
 
 template<typename type, TYPE_VISIBLE T>
-bool MainWidget<type, T>::setCurrentTab(int idTab)
+bool MainWidget<type, T>::setAntialiasing(int idTab, bool set)
 {
     if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
         return false;
 
-    int id{};
-    for (int i = 0; i < idTab; ++i) {
-        if (!m_tabs[i].deleteTab)
-            ++id;
-    }
-
-    m_tabWidget->setCurrentIndex(id);
+    m_tabs[idTab].OGLWidget->setAntialiasing(set);
 
     return true;
 }
 
 template<typename type, TYPE_VISIBLE T>
-void MainWidget<type, T>::setUpdateSceneAuto(bool set)
+void MainWidget<type, T>::setDensityMode(bool set)
 {
-    m_updateSceneAuto = set;
     for (auto &tab : m_tabs) {
         if (tab.deleteTab)
             continue;
 
-        tab.OGLWidget->setUpdateSceneAuto(set);
+        tab.OGLWidget->setDensityMode(set);
     }
 }
 
 template<typename type, TYPE_VISIBLE T>
-bool MainWidget<type, T>::setGraphVisible(int idGraph, bool show)
+bool MainWidget<type, T>::setDensityMode(int idTab, bool set)
 {
-    if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1)
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
         return false;
 
-    m_graphs[idGraph].show = show;
-    m_tabs[m_graphsIdTab[idGraph]].OGLWidget->setGraphVisible(idGraph, show);
-
-    if (show)
-        m_graphs[idGraph].button->setStyleSheet(QString("background-color: " + convertColorName(m_graphs[idGraph].color)
-                                                + "; border: 1px solid black;"));
-    else
-        m_graphs[idGraph].button->setStyleSheet("background-color: white; border: 1px solid black;");
+    m_tabs[idTab].OGLWidget->setDensityMode(set);
 
     return true;
 }
 
 template<typename type, TYPE_VISIBLE T>
-void MainWidget<type, T>::setGridVisible(bool show)
+void MainWidget<type, T>::setDensityDecay(double decay)
 {
     for (auto &tab : m_tabs) {
         if (tab.deleteTab)
             continue;
 
-        tab.OGLWidget->setGridVisible(show);
+        tab.OGLWidget->setDensityDecay(decay);
     }
 }
 
 template<typename type, TYPE_VISIBLE T>
-bool MainWidget<type, T>::setGridVisible(int idTab, bool show)
+bool MainWidget<type, T>::setDensityDecay(int idTab, double decay)
 {
     if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
         return false;
 
-    m_tabs[idTab].OGLWidget->setGridVisible(show);
+    m_tabs[idTab].OGLWidget->setDensityDecay(decay);
 
     return true;
 }
 
 template<typename type, TYPE_VISIBLE T>
-void MainWidget<type, T>::setGridCursorVisible(bool show)
+bool MainWidget<type, T>::setDensitySaturation(int idTab, double hits)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].OGLWidget->setDensitySaturation(hits);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setDensityColormap(int idTab, const std::vector<QRgb> &colors)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab || colors.size() < 2)
+        return false;
+
+    m_tabs[idTab].OGLWidget->setDensityColormap(colors);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setMeasureMode(bool set)
 {
     for (auto &tab : m_tabs) {
         if (tab.deleteTab)
             continue;
 
-        tab.OGLWidget->setGridCursorVisible(show);
+        tab.OGLWidget->setMeasureMode(set);
     }
 }
 
 template<typename type, TYPE_VISIBLE T>
-bool MainWidget<type, T>::setGridCursorVisible(int idTab, bool show)
+bool MainWidget<type, T>::setMeasureMode(int idTab, bool set)
 {
     if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
         return false;
 
-    m_tabs[idTab].OGLWidget->setGridCursorVisible(show);
+    m_tabs[idTab].OGLWidget->setMeasureMode(set);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::measureRange(int idTab, double begin, double end)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].OGLWidget->measureRange(begin, end);
 
     return true;
 }
@@ -1125,6 +2600,17 @@ bool MainWidget<type, T>::setCancelSelectButton(int idTab, Qt::Key button)
     return true;
 }
 
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setHudButton(int idTab, Qt::Key button)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return false;
+
+    m_tabs[idTab].OGLWidget->setHudButton(button);
+
+    return true;
+}
+
 template<typename type, TYPE_VISIBLE T>
 bool MainWidget<type, T>::swapVHButtons(int idTab)
 {
@@ -1139,21 +2625,151 @@ bool MainWidget<type, T>::swapVHButtons(int idTab)
 template<typename type, TYPE_VISIBLE T>
 bool MainWidget<type, T>::setValuesGraph(int idGraph, const std::vector<type> &graph)
 {
+    TRACE_SPAN("ingest setValuesGraph");
+
     if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1)
         return false;
 
+    // Values of series are changed together with its derived graphs
+    auto series = m_series.find(idGraph);
+    if (series != m_series.end()) {
+        series->second->patches.push_back(Patch{0, graph, true});
+        return true;
+    }
+
     m_tabs[m_graphsIdTab[idGraph]].OGLWidget->setValuesGraph(idGraph, graph);
 
     return true;
 }
 
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::appendValuesGraph(int idGraph, const std::vector<type> &values)
+{
+    return updateValuesGraph(idGraph, SIZE_MAX, values);
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::updateValuesGraph(int idGraph, size_t first, const std::vector<type> &values)
+{
+    TRACE_SPAN("ingest updateValuesGraph");
+
+    if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1 || m_derived.count(idGraph)
+            || !m_tabs[m_graphsIdTab[idGraph]].OGLWidget->hasValuesGraph(idGraph))
+        return false;
+
+    // Graph keeps its values in series from first change, so next changes don't copy them from widget
+    std::shared_ptr<Series> &series = m_series[idGraph];
+    if (!series)
+        series = std::make_shared<Series>();
+    series->patches.push_back(Patch{first, values, false});
+    if (!m_derivedTimer.isActive())
+        m_derivedTimer.start();
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setValuesGraph(int idGraph, const std::vector<type> &graph, const std::vector<double> &x)
+{
+    TRACE_SPAN("ingest setValuesGraph");
+
+    if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1 || graph.empty()
+            || graph.size() != x.size() || !std::is_sorted(x.begin(), x.end()))
+        return false;
+
+    std::vector<double> relative(x.size());
+    for (size_t i = 0; i < x.size(); ++i)
+        relative[i] = x[i] - x[0];
+
+    m_tabs[m_graphsIdTab[idGraph]].OGLWidget->setStartPointGraph(idGraph, x[0]);
+    m_tabs[m_graphsIdTab[idGraph]].OGLWidget->setValuesGraph(idGraph, graph, relative);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setPointsGraph(int idGraph, const std::vector<double> &x, const std::vector<double> &y)
+{
+    TRACE_SPAN("ingest setPointsGraph");
+
+    if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1 || x.empty() || x.size() != y.size())
+        return false;
+
+    m_tabs[m_graphsIdTab[idGraph]].OGLWidget->setPointsGraph(idGraph, x, y);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::addWaterfallRows(int idGraph, const std::vector<float> &rows)
+{
+    TRACE_SPAN("ingest addWaterfallRows");
+
+    if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1 || rows.empty())
+        return false;
+
+    m_tabs[m_graphsIdTab[idGraph]].OGLWidget->addRowsGraph(idGraph, rows.data(), rows.size());
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setWaterfallLevels(int idGraph, double low, double high)
+{
+    if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1 || high <= low)
+        return false;
+
+    m_tabs[m_graphsIdTab[idGraph]].OGLWidget->setLevelsGraph(idGraph, {low, high});
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setWaterfallColormap(int idGraph, const std::vector<QRgb> &colors)
+{
+    if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1 || colors.size() < 2)
+        return false;
+
+    m_tabs[m_graphsIdTab[idGraph]].OGLWidget->setColormapGraph(idGraph, colors);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setWaterfallRowStep(int idGraph, double step)
+{
+    if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1 || step <= 0)
+        return false;
+
+    m_tabs[m_graphsIdTab[idGraph]].OGLWidget->setRowStepGraph(idGraph, step);
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::setValuesGraphs(const std::vector<int> &idGraphs, const std::vector<std::vector<type>> &graphs)
+{
+    TRACE_SPAN("ingest setValuesGraphs");
+
+    if (idGraphs.size() != graphs.size())
+        return false;
+
+    UpdateGuard guard{*this};
+
+    bool result = true;
+    for (size_t i = 0; i < idGraphs.size(); ++i)
+        result &= setValuesGraph(idGraphs[i], graphs[i]);
+
+    return result;
+}
+
 template<typename type, TYPE_VISIBLE T>
 bool MainWidget<type, T>::setNameGraph(int idGraph, QString name)
 {
     if (m_graphsIdTab.size() <= idGraph || m_graphsIdTab[idGraph] == -1)
         return false;
 
-    m_graphs[idGraph].label->setText(name);
+    m_tabs[m_graphsIdTab[idGraph]].legend->setNameGraph(idGraph, name);
 
     return true;
 }
@@ -1179,10 +2795,7 @@ void MainWidget<type, T>::setColorGraph(QRgb color)
             continue;
 
         m_tabs[m_graphsIdTab[i]].OGLWidget->setColorGraph(i, color);
-        m_graphs[i].color = color;
-        if (m_graphs[i].turn)
-            m_graphs[i].button->setStyleSheet(
-                QString("background-color: " + convertColorName(color) + "; border: 1px solid black;"));
+        m_tabs[m_graphsIdTab[i]].legend->setColorGraph(i, color);
     }
 }
 
@@ -1193,10 +2806,7 @@ bool MainWidget<type, T>::setColorGraph(int idGraph, QRgb color)
         return false;
 
     m_tabs[m_graphsIdTab[idGraph]].OGLWidget->setColorGraph(idGraph, color);
-    m_graphs[idGraph].color = color;
-    if (m_graphs[idGraph].show)
-        m_graphs[idGraph].button->setStyleSheet(
-            QString("background-color: " + convertColorName(color) + "; border: 1px solid black;"));
+    m_tabs[m_graphsIdTab[idGraph]].legend->setColorGraph(idGraph, color);
 
     return true;
 }
@@ -1211,11 +2821,8 @@ void MainWidget<type, T>::setColorText(QRgb color)
             continue;
 
         tab.colorText = color;
-
-        for (auto &graph : tab.graphs)
-            graph.label->setStyleSheet("color: " + convertColorName(color) + ";");
+        tab.legend->setColorText(color);
     }
-
 }
 
 template<typename type, TYPE_VISIBLE T>
@@ -1225,8 +2832,7 @@ bool MainWidget<type, T>::setColorText(int idTab, QRgb color)
         return false;
 
     m_tabs[idTab].colorText = color;
-    for (auto &graph : m_tabs[idTab])
-        graph.label->setStyleSheet("color: " + convertColorName(color) + ";");
+    m_tabs[idTab].legend->setColorText(color);
 
     return true;
 }
@@ -1361,9 +2967,7 @@ void MainWidget<type, T>::setFontText(QString font)
             continue;
 
         tab.font = font;
-
-        for (auto &graph : tab.graphs)
-            graph.label->setStyleSheet("font-family: " + font + ";");
+        tab.legend->setFontText(font);
     }
 }
 
@@ -1374,8 +2978,7 @@ bool MainWidget<type, T>::setFontText(int idTab, QString font)
         return false;
 
     m_tabs[idTab].font = font;
-    for (auto &graph : m_tabs[idTab])
-        graph.label->setStyleSheet("font-family: " + font + ";");
+    m_tabs[idTab].legend->setFontText(font);
 
     return true;
 }
@@ -1472,6 +3075,12 @@ bool MainWidget<type, T>::setWidthAxes(int idTab, float width)
     return true;
 }
 
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setMemoryBudget(size_t bytes)
+{
+    m_memoryBudget = bytes;
+}
+
 template<typename type, TYPE_VISIBLE T>
 WidgetSignals *MainWidget<type, T>::getSignal()
 {
@@ -1482,18 +3091,107 @@ template<typename type, TYPE_VISIBLE T>
 int MainWidget<type, T>::getCurrentTab()
 {
     int id = m_tabWidget->currentIndex();
-    int i{};
-    for (int index = 0; index < id; ++i) {
-        if (!m_tabs[i].deleteTab)
-            ++index;
-    }
+    auto found = std::find_if(m_tabs.begin(), m_tabs.end(), [id](const Tab & tab) {
+        return !tab.deleteTab && tab.idWidget == id;
+    });
+
+    return found != m_tabs.end() ? static_cast<int>(found - m_tabs.begin()) : -1;
+}
+
+template<typename type, TYPE_VISIBLE T>
+FrameStatistics MainWidget<type, T>::getFrameStatistics(int idTab)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return FrameStatistics{};
+
+    return m_tabs[idTab].OGLWidget->getFrameStatistics();
+}
+
+template<typename type, TYPE_VISIBLE T>
+int MainWidget<type, T>::getQualityLevel(int idTab)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return -1;
+
+    return m_tabs[idTab].OGLWidget->getQualityLevel();
+}
+
+template<typename type, TYPE_VISIBLE T>
+std::unordered_map<int, typename OpenGLWidget<type, T>::RangeStatistics> MainWidget<type, T>::getRangeStatistics(int idTab)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return {};
+
+    return m_tabs[idTab].OGLWidget->getRangeStatistics();
+}
+
+template<typename type, TYPE_VISIBLE T>
+std::pair<double, double> MainWidget<type, T>::getMeasuredRange(int idTab)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return {0, 0};
+
+    return m_tabs[idTab].OGLWidget->getMeasuredRange();
+}
+
+template<typename type, TYPE_VISIBLE T>
+std::vector<typename OpenGLWidget<type, T>::SampleReadout> MainWidget<type, T>::getReadout(int idTab)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return {};
+
+    return m_tabs[idTab].OGLWidget->getReadout();
+}
 
-    return i;
+template<typename type, TYPE_VISIBLE T>
+int MainWidget<type, T>::getPickedGraph(int idTab)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return -1;
+
+    return m_tabs[idTab].OGLWidget->getPickedGraph();
+}
+
+template<typename type, TYPE_VISIBLE T>
+int MainWidget<type, T>::getHoveredGraph(int idTab)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return -1;
+
+    return m_tabs[idTab].OGLWidget->getHoveredGraph();
+}
+
+template<typename type, TYPE_VISIBLE T>
+int MainWidget<type, T>::pickGraph(int idTab, QPoint point)
+{
+    if (m_tabs.size() <= idTab || m_tabs[idTab].deleteTab)
+        return -1;
+
+    return m_tabs[idTab].OGLWidget->pickGraph(point);
+}
+
+template<typename type, TYPE_VISIBLE T>
+void MainWidget<type, T>::setTracingEnabled(bool enabled)
+{
+    TraceRecorder::instance().setEnabled(enabled);
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool MainWidget<type, T>::dumpTrace(const QString &path)
+{
+    return TraceRecorder::instance().dumpChromeTrace(path);
 }
 
 template<typename type, TYPE_VISIBLE T>
 void MainWidget<type, T>::updateGridValues(int idTab)
 {
+    // Labels of tab that was never shown are made when it's built and drawn
+    if (!m_tabs[idTab].built)
+        return;
+
+    FrameTiming::ScopedTimer timer{m_tabs[idTab].OGLWidget->getFrameTiming(), FRAME_PHASE::GRID_VALUES};
+    TRACE_SPAN("updateGridValues");
+
     // Update grid values and its positions
     std::pair<std::vector<int>, std::vector<int>> axesValue = m_tabs[idTab].OGLWidget->getGridValues();
 
@@ -1517,28 +3215,41 @@ void MainWidget<type, T>::updateGridValues(int idTab)
 
     QRgb colorText = m_tabs[idTab].colorText;
 
+    // Labels get enough digits to differ from neighbours at any zoom, last value is cursor
+    auto precision = [](const std::vector<double> &values, int minimum) {
+        int result = minimum;
+        for (size_t i = 1; i + 1 < values.size(); ++i) {
+            double step = std::abs(values[i] - values[i - 1]);
+            if (step > 0)
+                result = std::max(result, static_cast<int>(std::ceil(std::log10(std::abs(values[i]) / step + 1))) + 2);
+        }
+        return std::min(result, 17);
+    };
+    int precisionX = precision(Values.first, 6);
+    int precisionY = precision(Values.second, 3);
+
     for (size_t i = 0; i < axesValue.first.size() - 1; ++i) {
-        QLabel *label = new QLabel(QString::number(Values.first[i]), m_tabs[idTab].XAxis);
+        QLabel *label = new QLabel(QString::number(Values.first[i], 'g', precisionX), m_tabs[idTab].XAxis);
         label->move(axesValue.first[i] - 10, -2);
         label->setStyleSheet("color: " + convertColorName(colorText) + ";");
         label->show();
     }
 
     for (size_t i = 0; i < axesValue.second.size() - 1; ++i) {
-        QLabel *label = new QLabel(QString::number(Values.second[i], 'g', 3), m_tabs[idTab].YAxis);
+        QLabel *label = new QLabel(QString::number(Values.second[i], 'g', precisionY), m_tabs[idTab].YAxis);
         label->setFixedHeight(16);
         label->move(0, axesValue.second[i] - 12);
         label->setStyleSheet("color: " + convertColorName(colorText) + ";");
         label->show();
     }
 
-    QLabel *cursorValueXLable = new QLabel(QString::number(Values.first.back()), m_tabs[idTab].XAxis);
+    QLabel *cursorValueXLable = new QLabel(QString::number(Values.first.back(), 'g', precisionX), m_tabs[idTab].XAxis);
     cursorValueXLable->move(axesValue.first.back() - 8, -2);
     cursorValueXLable->setStyleSheet("background-color: " + convertColorName(m_tabs[idTab].colorBackCursor) + ";"
                                      "color: " + convertColorName(colorText) + ";");
     cursorValueXLable->show();
 
-    QLabel *cursorValueYLable = new QLabel(QString::number(Values.second.back()), m_tabs[idTab].YAxis);
+    QLabel *cursorValueYLable = new QLabel(QString::number(Values.second.back(), 'g', std::max(precisionY, 6)), m_tabs[idTab].YAxis);
     cursorValueYLable->setFixedHeight(16);
     cursorValueYLable->move(0, axesValue.second.back() - 12);
     cursorValueYLable->setStyleSheet("background-color: " + convertColorName(m_tabs[idTab].colorBackCursor) + ";"
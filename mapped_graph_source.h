@@ -0,0 +1,355 @@
+#ifndef MAPPED_GRAPH_SOURCE_H
+#define MAPPED_GRAPH_SOURCE_H
+
+#include "graph_source.h"
+
+#include <QFile>
+
+#include <list>
+#include <thread>
+#include <unordered_map>
+
+#define MAPPED_CHUNK_BYTES (64ull << 20) ///< Size of one mapped window of file
+#define MAPPED_MEMORY_BUDGET (1024ull << 20) ///< Default budget of resident memory of one file
+#define MAPPED_CONVERT_SAMPLES (1 << 20) ///< Number of samples converted at once by background pass
+
+///
+/// \brief The MappedFileWindows class - samples of file mapped by windows, least recently used windows are
+/// unmapped to stay in memory budget. Used only from one thread
+///
+class MappedFileWindows
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    MappedFileWindows() = default;
+    ~MappedFileWindows()
+    {
+        for (auto &chunk : m_chunks)
+            m_file.unmap(chunk.second);
+    }
+
+    MappedFileWindows(const MappedFileWindows &) = delete;
+    MappedFileWindows &operator=(const MappedFileWindows &) = delete;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief open - open file for reading
+    /// \param path - path of file
+    /// \return - true is all good, false is mistake
+    ///
+    bool open(const QString &path)
+    {
+        m_file.setFileName(path);
+        return m_file.open(QIODevice::ReadOnly);
+    }
+
+    ///
+    /// \brief read - read samples and convert them in type of graph
+    /// \param first - index of first sample
+    /// \param count - number of samples, clamped to number of samples in file
+    /// \param values - where samples are written
+    /// \return - true is all good, false is mistake
+    ///
+    template<typename type>
+    bool read(size_t first, size_t count, std::vector<type> &values)
+    {
+        if (first >= m_count) {
+            values.clear();
+            return true;
+        }
+
+        count = std::min<size_t>(count, m_count - first);
+        values.resize(count);
+
+        size_t done{};
+        while (done < count) {
+            size_t index = first + done;
+            size_t chunk = index / m_chunkSamples;
+            size_t offset = index % m_chunkSamples;
+            size_t take = std::min(count - done, m_chunkSamples - offset);
+
+            const uchar *data = mapChunk(chunk);
+            if (!data)
+                return false;
+
+            convertSamples(m_sampleType, data + offset * m_sampleSize, take, values.data() + done);
+            done += take;
+        }
+
+        return true;
+    }
+
+    // --- Setters ---
+
+    ///
+    /// \brief setLayout - set where samples are placed in file
+    /// \param dataOffset - offset of first sample from beginning of file
+    /// \param sampleType - type of samples
+    /// \param count - number of samples, clamped to samples present in file
+    /// \return - true is all good, false is mistake
+    ///
+    bool setLayout(qint64 dataOffset, SAMPLE_TYPE sampleType, quint64 count)
+    {
+        m_sampleType = sampleType;
+        m_sampleSize = sampleTypeSize(sampleType);
+        if (m_sampleSize == 0 || dataOffset > m_file.size())
+            return false;
+
+        m_dataOffset = dataOffset;
+        m_count = std::min<quint64>(count, (m_file.size() - dataOffset) / m_sampleSize);
+        m_chunkSamples = MAPPED_CHUNK_BYTES / m_sampleSize;
+
+        return true;
+    }
+
+    ///
+    /// \brief setMemoryBudget - set budget of mapped windows
+    /// \param bytes - budget in bytes
+    ///
+    void setMemoryBudget(size_t bytes)
+    {
+        m_budget = bytes;
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief count - number of samples available in file
+    /// \return - number of samples
+    ///
+    quint64 count() const
+    {
+        return m_count;
+    }
+
+private:
+
+    // --- Helper methods ---
+
+    ///
+    /// \brief mapChunk - get mapped window of file, least recently used windows over budget are unmapped
+    /// \param chunk - index of window
+    /// \return - pointer to samples of window, nullptr if mapping failed
+    ///
+    const uchar *mapChunk(size_t chunk)
+    {
+        auto found = m_chunkIndex.find(chunk);
+        if (found != m_chunkIndex.end()) {
+            m_chunks.splice(m_chunks.begin(), m_chunks, found->second);
+            return found->second->second;
+        }
+
+        size_t maxChunks = std::max<size_t>(1, m_budget / MAPPED_CHUNK_BYTES);
+        while (m_chunks.size() >= maxChunks) {
+            m_file.unmap(m_chunks.back().second);
+            m_chunkIndex.erase(m_chunks.back().first);
+            m_chunks.pop_back();
+        }
+
+        qint64 offset = m_dataOffset + static_cast<qint64>(chunk * m_chunkSamples * m_sampleSize);
+        qint64 bytes = std::min<qint64>(m_chunkSamples, m_count - chunk * m_chunkSamples) * m_sampleSize;
+        uchar *data = m_file.map(offset, bytes);
+        if (!data)
+            return nullptr;
+
+        m_chunks.emplace_front(chunk, data);
+        m_chunkIndex[chunk] = m_chunks.begin();
+
+        return data;
+    }
+
+private:
+
+    // --- Fields ---
+
+    using ChunkList = std::list<std::pair<size_t, uchar *>>;
+
+    QFile                                            m_file; ///< Mapped file
+    SAMPLE_TYPE             m_sampleType{SAMPLE_TYPE::INT16}; ///< Type of samples
+    size_t                                  m_sampleSize{0}; ///< Size of sample in bytes
+    qint64                                  m_dataOffset{0}; ///< Offset of first sample
+    quint64                                      m_count{0}; ///< Number of samples
+    size_t                                m_chunkSamples{1}; ///< Number of samples in one window
+    size_t                    m_budget{MAPPED_MEMORY_BUDGET}; ///< Budget of mapped windows in bytes
+
+    ChunkList                                      m_chunks; ///< Mapped windows, most recently used is first
+    std::unordered_map<size_t, ChunkList::iterator> m_chunkIndex; ///< Window by index
+};
+
+///
+/// \brief The MappedGraphSource class - graph backed by memory-mapped raw file (GraphFileHeader and samples).
+/// Half of memory budget is for mapped windows, other half is for levels of detail built by background pass
+/// and published as it goes
+///
+template<typename type>
+class MappedGraphSource : public GraphSource<type>
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    MappedGraphSource() = default;
+    ~MappedGraphSource() override;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief open - open file and start background building of levels of detail
+    /// \param path - path of file
+    /// \return - true is all good, false is mistake
+    ///
+    bool open(const QString &path);
+
+    bool read(size_t first, size_t count, std::vector<type> &values) override;
+
+    // --- Setters ---
+
+    ///
+    /// \brief setMemoryBudget - set budget of resident memory, must be called before open
+    /// \param bytes - budget in bytes
+    ///
+    void setMemoryBudget(size_t bytes);
+
+    // --- Getters ---
+
+    size_t size() const override;
+    double startPoint() const override;
+    double step() const override;
+
+private:
+
+    // --- Helper methods ---
+
+    ///
+    /// \brief buildPyramid - background pass over file, builds levels of detail with separate file handle
+    /// \param path - path of file
+    ///
+    void buildPyramid(QString path);
+
+private:
+
+    // --- Fields ---
+
+    MappedFileWindows                             m_windows; ///< Samples read on demand
+    GraphFileHeader                                m_header; ///< Header of file
+    size_t                    m_budget{MAPPED_MEMORY_BUDGET}; ///< Budget of resident memory in bytes
+
+    std::thread                                   m_builder; ///< Background pass building levels of detail
+    std::atomic<bool>                          m_stop{false}; ///< Stop background pass
+};
+
+template<typename type>
+MappedGraphSource<type>::~MappedGraphSource()
+{
+    m_stop = true;
+    if (m_builder.joinable())
+        m_builder.join();
+}
+
+template<typename type>
+bool MappedGraphSource<type>::open(const QString &path)
+{
+    QFile file{path};
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    if (file.read(reinterpret_cast<char *>(&m_header), sizeof(m_header)) != sizeof(m_header)
+            || m_header.magic != GRAPH_FILE_MAGIC || m_header.version != GRAPH_FILE_VERSION
+            || m_header.headerSize < sizeof(m_header))
+        return false;
+
+    m_windows.setMemoryBudget(m_budget / 2);
+    if (!m_windows.open(path)
+            || !m_windows.setLayout(m_header.headerSize, static_cast<SAMPLE_TYPE>(m_header.sampleType), m_header.count))
+        return false;
+
+    // Samples beyond end of file aren't available
+    m_header.count = m_windows.count();
+
+    m_builder = std::thread(&MappedGraphSource<type>::buildPyramid, this, path);
+
+    return true;
+}
+
+template<typename type>
+bool MappedGraphSource<type>::read(size_t first, size_t count, std::vector<type> &values)
+{
+    return m_windows.read(first, count, values);
+}
+
+template<typename type>
+void MappedGraphSource<type>::setMemoryBudget(size_t bytes)
+{
+    m_budget = bytes;
+}
+
+template<typename type>
+size_t MappedGraphSource<type>::size() const
+{
+    return m_header.count;
+}
+
+template<typename type>
+double MappedGraphSource<type>::startPoint() const
+{
+    return m_header.startPoint;
+}
+
+template<typename type>
+double MappedGraphSource<type>::step() const
+{
+    return m_header.step;
+}
+
+template<typename type>
+void MappedGraphSource<type>::buildPyramid(QString path)
+{
+    QFile file{path};
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    using Bucket = typename MinMaxPyramid<type>::Bucket;
+
+    SAMPLE_TYPE sampleType = static_cast<SAMPLE_TYPE>(m_header.sampleType);
+    size_t sampleSize = sampleTypeSize(sampleType);
+    size_t chunkSamples = MAPPED_CHUNK_BYTES / sampleSize;
+
+    // Coarsen finest level until levels of detail fit in quarter of budget
+    size_t baseBlock = LOD_BASE_BLOCK;
+    while (m_header.count / baseBlock * 2 * sizeof(Bucket) > m_budget / 4)
+        baseBlock *= 2;
+
+    MinMaxPyramid<type> pyramid{baseBlock};
+    std::vector<type> values(MAPPED_CONVERT_SAMPLES);
+
+    size_t chunks = (m_header.count + chunkSamples - 1) / chunkSamples;
+    size_t nextPublish = 1;
+    for (size_t chunk = 0; chunk < chunks && !m_stop; ++chunk) {
+        qint64 offset = m_header.headerSize + static_cast<qint64>(chunk * chunkSamples * sampleSize);
+        size_t count = std::min<size_t>(chunkSamples, m_header.count - chunk * chunkSamples);
+        uchar *data = file.map(offset, count * sampleSize);
+        if (!data)
+            return;
+
+        for (size_t done = 0; done < count; done += MAPPED_CONVERT_SAMPLES) {
+            size_t take = std::min<size_t>(MAPPED_CONVERT_SAMPLES, count - done);
+            convertSamples(sampleType, data + done * sampleSize, take, values.data());
+            pyramid.append(values.data(), take);
+        }
+        file.unmap(data);
+
+        // Publish copies at doubling points, so overall copying stays linear
+        if (chunk + 1 == nextPublish && chunk + 1 < chunks) {
+            this->publishPyramid(std::make_shared<const MinMaxPyramid<type>>(pyramid));
+            nextPublish *= 2;
+        }
+    }
+
+    if (!m_stop)
+        this->publishPyramid(std::make_shared<const MinMaxPyramid<type>>(std::move(pyramid)));
+}
+
+#endif // MAPPED_GRAPH_SOURCE_H
@@ -2,21 +2,59 @@
 #define OPENGL_WIDGET_H
 
 #include "widget_signals.h"
+#include "frame_timing.h"
+#include "graph_source.h"
+#include "task_pool.h"
+#include "gpu_buffer_cache.h"
+#include "camera.h"
+#include "scatter_index.h"
+#include "density_buffer.h"
+#include "waterfall.h"
+#include "range_sums.h"
+#include "pick_buffer.h"
 
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions>
+#include <QOpenGLTimerQuery>
+#include <QPainter>
 #include <QMouseEvent>
 #include <QRgb>
+#include <QTimer>
 
 #include <unordered_map>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 #define MIN_ZOOM 0.5 ///< Minimum zoom
 #define ZOOM_FACTOR_GRID 2 ///< At what increase or decrease in zoom grid changes
 #define START_ZOOM 1 ///< Initial zoom in initialization
 #define ZOOM_COEFFICIENT 0.05 ///< Coefficient of change of zoom
 #define DEFAULT_STEP_GRID 10 ///<
-#define MAX_ZOOM 100 ///<
+#define MAX_ZOOM 100 ///< Maximum zoom of one selection relative to current zoom
+#define MAX_ZOOM_SCENE 1e12 ///< Maximum zoom, coordinates of view are still exact in double
+#define GRID_MAX_LINES 1000 ///< Maximum number of lines of grid along one axis
+#define FRAME_STATISTICS_PERIOD 30 ///< Number of frames between signals of frame statistics
+#define GPU_TIMER_QUERIES 3 ///< Number of timer queries in flight, results are read without stalls
+#define HUD_MAX_GRAPHS 16 ///< Maximum number of graphs listed in performance overlay
+#define HUD_UPDATE_MS 1000 ///< Period of counting of FPS and uploaded bytes, milliseconds
+#define READOUT_MAX_GRAPHS 16 ///< Maximum number of graphs listed in cursor readout
+#define READOUT_MARKER_SIZE 6 ///< Size of marker of nearest sample of graph, pixels
+#define CURSOR_SNAP_PIXELS 20 ///< Maximum distance from cursor to sample to which cursor grid snaps, pixels
+#define SOURCE_MAX_RAW_SAMPLES (1 << 22) ///< Maximum number of raw samples of graph source read for one frame
+#define DECIMATE_SAMPLES_PER_PIXEL 2 ///< Samples per pixel from which graph with own X is drawn by pixel columns
+#define SCATTER_POINT_SIZE 2 ///< Size of point in scatter mode relative to width of graph, pixels
+#define SCATTER_POINTS_PER_PIXEL 2 ///< Points of cloud drawn per pixel of dense cell, more are invisible under neighbours
+#define REFINE_BUDGET_MS 8 ///< Default budget of frame time for refinement of graphs, milliseconds
+#define REFINE_COARSE_LEVELS 4 ///< Maximum number of levels above needed one drawn after view change
+#define QUALITY_LEVELS 4 ///< Number of quality levels, 0 is full quality
+#define QUALITY_NO_ANTIALIASING 1 ///< Quality level from which antialiasing of graphs is disabled
+#define QUALITY_THIN_GRID 2 ///< Quality level from which grid is thinned and each level adds coarser level of detail
+#define QUALITY_CHECK_FRAMES 10 ///< Number of frames whose time is averaged before quality level is changed
+#define QUALITY_RESTORE_RATIO 0.5 ///< Quality is raised when frame time is under this part of target
+#define QUALITY_IDLE_MS 500 ///< Full quality is restored after this time without frames, milliseconds
+#define BUFFER_MAX_SAMPLES (1 << 24) ///< Maximum number of samples of graph kept in GPU buffer, indexes stay exact in float
+#define LOD_TASK_SAMPLES (LOD_BASE_BLOCK << 14) ///< Number of samples in one task of building levels of detail
 
 ///
 /// \brief The TYPE_VISIBLE enum - type of data that OpenGL will display
@@ -28,12 +66,20 @@ enum class TYPE_VISIBLE : int {
     DOUBLE
 };
 
+///
+/// \brief The OpenGLWidgetProbe class - access to internal steps of frame, defined by benchmarks and tests
+///
+template<typename type, TYPE_VISIBLE T>
+class OpenGLWidgetProbe;
+
 ///
 /// \brief The OpenGLWidget class - class responsible for rendering
 ///
 template<typename type, TYPE_VISIBLE T>
 class OpenGLWidget : public QOpenGLWidget, protected QOpenGLFunctions
 {
+    friend class OpenGLWidgetProbe<type, T>;
+
 public:
 
     // --- Helper structs ---
@@ -45,7 +91,8 @@ public:
         UNDEFINED = -1,
         LINE,
         COLUMN,
-        RECTANGLE
+        RECTANGLE,
+        SCATTER
     };
 
     ///
@@ -63,9 +110,20 @@ public:
     ///
     struct GraphData {
         std::vector<type> graph; ///< array of graph values
-        type      startPoint{0}; ///< starting point of graph
+        double    startPoint{0}; ///< starting point of graph, for graph with own X it's X of first sample
         QRgb           color{0}; ///< graph color
         bool         show{true}; ///< show or unshow graph
+        std::shared_ptr<GraphSource<type>> source; ///< samples read on demand instead of graph, step and
+        ///< starting point are taken from it
+        std::shared_ptr<const MinMaxPyramid<type>> pyramid; ///< levels of detail of graph, built with graph values
+        std::shared_ptr<const RangeSums<type>> sums; ///< prefix sums of graph values, built with levels of detail
+        size_t      generation{0}; ///< version of graph values, older results of building are dropped
+        quint64           hash{0}; ///< hash of graph values, equal graphs share GPU buffer, 0 is no buffer
+        std::vector<double>    x; ///< sorted X of samples relative to startPoint, empty if samples are evenly
+        ///< spaced by step
+        std::shared_ptr<const ScatterIndex> scatter; ///< index of cloud of points, graph values aren't used
+        std::shared_ptr<Waterfall> waterfall; ///< history of rows drawn as intensity, values of row are spaced by
+        ///< step from starting point, graph values aren't used
 
         // --- Constructors/destructors ---
 
@@ -73,22 +131,63 @@ public:
         GraphData(std::vector<type> &graph, QRgb color)
             : graph{graph}, color{color}
         {}
+        GraphData(std::vector<type> &graph, std::vector<double> &&x, double startPoint, QRgb color)
+            : graph{graph}, startPoint{startPoint}, color{color}, x{std::move(x)}
+        {}
+        GraphData(std::shared_ptr<GraphSource<type>> source, QRgb color)
+            : startPoint(source->startPoint()), color{color}, source{std::move(source)}
+        {}
         ~GraphData() = default;
     };
 
+    ///
+    /// \brief The RenderCounters struct - counters of rendering, shown in performance overlay
+    ///
+    struct RenderCounters {
+        size_t      vertices{0}; ///< Vertices submitted in last frame
+        size_t       samples{0}; ///< Samples stored in all graphs
+        size_t     drawCalls{0}; ///< Draw calls in last frame
+        double uploadedBytes{0}; ///< Bytes transferred to GPU per second
+        double           fps{0}; ///< Frames per second
+        double     frameTime{0}; ///< CPU time of last frame, milliseconds
+        std::unordered_map<int, int> lodLevels; ///< Level of detail of each drawn graph, 0 is full resolution
+    };
+
+    ///
+    /// \brief The RangeStatistics struct - statistics of samples of graph in range of X
+    ///
+    struct RangeStatistics {
+        size_t         count{0}; ///< Number of samples in range, other fields are undefined if it's 0
+        type             min{}; ///< Minimum of samples
+        type             max{}; ///< Maximum of samples
+        double         mean{0}; ///< Mean of samples, NaN for graph source if range is too long to be read
+        double          rms{0}; ///< Root mean square of samples, NaN for graph source if range is too long to be read
+    };
+
+    ///
+    /// \brief The SampleReadout struct - sample of graph nearest to cursor along X
+    ///
+    struct SampleReadout {
+        int       idGraph{-1}; ///< Id of graph
+        size_t      index{0}; ///< Index of sample
+        double          x{0}; ///< X of sample
+        type        value{}; ///< Value of sample
+    };
+
     // --- Constructors/destructors ---
 
     OpenGLWidget(int id, QWidget *parent = nullptr);
-    ~OpenGLWidget() = default;
+    ~OpenGLWidget();
 
     // --- Main methods ---
 
     ///
     /// \brief addGraph - add graph to scene
     /// \param idGraph - id of graph
-    /// \param graph - all data on graph
+    /// \param graph - all data on graph, values are moved to levels of detail built from them, so pass it with
+    /// std::move to avoid copy
     ///
-    void addGraph(int idGraph, GraphData &graph);
+    void addGraph(int idGraph, GraphData graph);
 
     ///
     /// \brief setValuesGraph - set array of graph values
@@ -97,6 +196,51 @@ public:
     ///
     void setValuesGraph(int idGraph, const std::vector<type> &graph);
 
+    ///
+    /// \brief setValuesGraph - set array of graph values and their X
+    /// \param idGraph - id of graph
+    /// \param graph - array of graph values
+    /// \param x - sorted X of values relative to starting point of graph
+    ///
+    void setValuesGraph(int idGraph, const std::vector<type> &graph, const std::vector<double> &x);
+
+    ///
+    /// \brief setPointsGraph - set cloud of points, graph is drawn as points, index of cloud is built in pool
+    /// \param idGraph - id of graph
+    /// \param x - coordinates X of points
+    /// \param y - coordinates Y of points, same number as X
+    ///
+    void setPointsGraph(int idGraph, std::vector<double> x, std::vector<double> y);
+
+    ///
+    /// \brief addRowsGraph - append rows to waterfall, only new rows are uploaded when widget is drawn
+    /// \param idGraph - id of graph
+    /// \param values - values of rows one after another
+    /// \param count - number of values
+    ///
+    void addRowsGraph(int idGraph, const float *values, size_t count);
+
+    ///
+    /// \brief setLevelsGraph - set values of waterfall shown by first and last colors of colormap
+    /// \param idGraph - id of graph
+    /// \param levels - lowest and highest values
+    ///
+    void setLevelsGraph(int idGraph, std::pair<double, double> levels);
+
+    ///
+    /// \brief setColormapGraph - set colormap of waterfall
+    /// \param idGraph - id of graph
+    /// \param colors - colors evenly spaced from lowest to highest value, at least two
+    ///
+    void setColormapGraph(int idGraph, const std::vector<QRgb> &colors);
+
+    ///
+    /// \brief setRowStepGraph - set distance between rows of waterfall along Y
+    /// \param idGraph - id of graph
+    /// \param step - distance in scene measure
+    ///
+    void setRowStepGraph(int idGraph, double step);
+
     ///
     /// \brief deleteGraph - delete graph from scene
     /// \param idGraph - id of graph
@@ -110,11 +254,34 @@ public:
     ///
     bool existsGraph(int idGraph);
 
+    ///
+    /// \brief samplesGraph - copy samples of graph for derived graph, samples are copied only if values or taken
+    /// range are changed since last copy
+    /// \param idGraph - id of graph
+    /// \param visible - whether to take visible samples, else latest samples
+    /// \param generation - version of values of last copy, updated
+    /// \param first - index of first sample of last copy, updated
+    /// \param out - copied samples
+    /// \param count - maximum number of samples, number of copied samples
+    /// \return - false if nothing is copied
+    ///
+    bool samplesGraph(int idGraph, bool visible, size_t &generation, size_t &first, type *out, size_t &count);
+
     ///
     /// \brief updateScene - update scene
     ///
     void updateScene();
 
+    ///
+    /// \brief beginUpdate - start transaction, until its end changes of graphs are only recorded, calls may be nested
+    ///
+    void beginUpdate();
+
+    ///
+    /// \brief endUpdate - end transaction, levels of detail, scene, grid and repaint are updated once
+    ///
+    void endUpdate();
+
     ///
     /// \brief swapMouseButton - swap mouse button
     ///
@@ -134,6 +301,27 @@ public:
     ///
     void setSignal(WidgetSignals *signal);
 
+    ///
+    /// \brief setTaskPool - set pool in which levels of detail and extents of graphs are built, without pool
+    /// they are built in calling thread
+    /// \param pool - pool of threads
+    ///
+    void setTaskPool(TaskPool *pool);
+
+    ///
+    /// \brief setBufferCache - set cache of GPU buffers, widgets of one context group share it, so equal graphs
+    /// are uploaded once
+    /// \param cache - cache of GPU buffers
+    ///
+    void setBufferCache(std::shared_ptr<GpuBufferCache> cache);
+
+    ///
+    /// \brief setSuspended - whether widget is in hidden tab, hidden widget only records changes of data, levels of
+    /// detail, scene and grid are updated when it's shown again
+    /// \param set - whether widget is suspended
+    ///
+    void setSuspended(bool set);
+
     ///
     /// \brief setStartPointGraph - set point of beginning of graph
     /// \param idGraph - id of graph
@@ -191,6 +379,12 @@ public:
     ///
     void setCancelSelectButton(Qt::Key button);
 
+    ///
+    /// \brief setHudButton - set button which will show or hide performance overlay
+    /// \param button - button which will show or hide performance overlay
+    ///
+    void setHudButton(Qt::Key button);
+
     ///
     /// \brief swapVHButtons - swap buttons which will change scene in vertical and horizontal space
     ///
@@ -215,6 +409,98 @@ public:
     ///
     void setGridCursorVisible(bool show);
 
+    ///
+    /// \brief setHudVisible - whether to show performance overlay
+    /// \param show - whether to show item
+    ///
+    void setHudVisible(bool show);
+
+    ///
+    /// \brief setReadoutVisible - whether to show values of samples of visible graphs nearest to cursor
+    /// \param show - whether to show item
+    ///
+    void setReadoutVisible(bool show);
+
+    ///
+    /// \brief setCursorSnap - whether cursor grid snaps to nearest sample of visible graphs near cursor
+    /// \param set - whether to snap
+    ///
+    void setCursorSnap(bool set);
+
+    ///
+    /// \brief setPicking - whether click by zoom button without selection picks graph under cursor, picked graph is
+    /// reported by signal graphPicked
+    /// \param set - whether to pick
+    ///
+    void setPicking(bool set);
+
+    ///
+    /// \brief setPickOnHover - whether graph under cursor is picked while mouse moves without buttons, change of
+    /// graph is reported by signal graphHovered
+    /// \param set - whether to pick
+    ///
+    void setPickOnHover(bool set);
+
+    ///
+    /// \brief setFrameBudget - set budget of frame time, p95 of CPU or GPU time over it is reported by signal
+    /// \param ms - budget in milliseconds, 0 disables checking
+    ///
+    void setFrameBudget(double ms);
+
+    ///
+    /// \brief setRefineBudget - set budget of frame time for progressive rendering, after view change graphs are
+    /// drawn from coarser levels of detail and refined by one level each frame while paint time is in budget
+    /// \param ms - budget in milliseconds, 0 disables progressive rendering
+    ///
+    void setRefineBudget(double ms);
+
+    ///
+    /// \brief setQualityTarget - set target of frame time for quality governor, when average frame time is over it
+    /// quality level is lowered (antialiasing off, then thinner grid and coarser levels of detail), when it's far
+    /// under target or widget is idle quality is raised
+    /// \param ms - target in milliseconds, 0 disables governor and sets full quality
+    ///
+    void setQualityTarget(double ms);
+
+    ///
+    /// \brief setAntialiasing - whether to draw graphs with antialiased lines at full quality
+    /// \param set - whether to antialias lines
+    ///
+    void setAntialiasing(bool set);
+
+    ///
+    /// \brief setDensityMode - whether to draw graphs as intensity: hits of all graphs in each pixel are mapped
+    /// through colormap, so heavily overlapping graphs stay readable. Colors of graphs aren't used
+    /// \param set - whether to draw intensity
+    ///
+    void setDensityMode(bool set);
+
+    ///
+    /// \brief setDensityDecay - set persistence of intensity, hits of previous frames fade by decay each frame
+    /// until view is changed
+    /// \param decay - part of hits kept from previous frame, 0 shows only current frame
+    ///
+    void setDensityDecay(double decay);
+
+    ///
+    /// \brief setDensitySaturation - set number of hits of pixel shown by last color of colormap
+    /// \param hits - number of hits
+    ///
+    void setDensitySaturation(double hits);
+
+    ///
+    /// \brief setDensityColormap - set colormap of intensity
+    /// \param colors - colors evenly spaced from least to most hits, at least two
+    ///
+    void setDensityColormap(const std::vector<QRgb> &colors);
+
+    ///
+    /// \brief setMeasureMode - whether selection by zoom button measures graphs in selected range of X instead of
+    /// zooming, results are reported by signal
+    /// \param set - whether to measure
+    ///
+    void setMeasureMode(bool set);
+
     ///
     /// \brief setColorGraph - set graph color
     /// \param idGraph - id of graph
@@ -296,6 +582,116 @@ public:
     ///
     std::pair<std::vector<double>&, std::vector<double>&> getValues();
 
+    ///
+    /// \brief getFrameStatistics - get rolling statistics (p50/p95/max) of each phase of frame
+    /// \return - statistics of frame phases
+    ///
+    FrameStatistics getFrameStatistics();
+
+    ///
+    /// \brief getFrameTiming - get measurements of frame phases, used to add phases measured outside
+    /// \return - measurements of frame phases
+    ///
+    FrameTiming &getFrameTiming();
+
+    ///
+    /// \brief getRenderCounters - get counters of rendering of last frame
+    /// \return - counters of rendering
+    ///
+    const RenderCounters &getRenderCounters();
+
+    ///
+    /// \brief isRefined - whether last frame drew all graphs at needed level of detail
+    /// \return - true if refinement is complete
+    ///
+    bool isRefined();
+
+    ///
+    /// \brief getQualityLevel - get quality level chosen by quality governor
+    /// \return - quality level, 0 is full quality
+    ///
+    int getQualityLevel();
+
+    ///
+    /// \brief getStepGraph - get distance between each value on graphs
+    /// \return - distance in scene measure
+    ///
+    double getStepGraph();
+
+    ///
+    /// \brief getStartPointGraph - get point of beginning of graph
+    /// \param idGraph - id of graph
+    /// \return - point of beginning, 0 if graph doesn't exist
+    ///
+    double getStartPointGraph(int idGraph);
+
+    ///
+    /// \brief getValuesGraph - get latest values of graph, including values which aren't shown yet
+    /// \param idGraph - id of graph
+    /// \param values - values of graph
+    /// \return - false if graph has no values in memory with evenly spaced samples or its values are being built
+    ///
+    bool getValuesGraph(int idGraph, std::vector<type> &values);
+
+    ///
+    /// \brief hasValuesGraph - whether graph keeps values in memory with evenly spaced samples, so they can be taken
+    /// and changed by parts; graphs from files, with own X, scatter clouds and waterfalls can't
+    /// \param idGraph - id of graph
+    /// \return - true if graph keeps values
+    ///
+    bool hasValuesGraph(int idGraph);
+
+    ///
+    /// \brief getRangeStatistics - get statistics of graphs in last measured range
+    /// \return - statistics of each graph with samples in range
+    ///
+    const std::unordered_map<int, RangeStatistics> &getRangeStatistics();
+
+    ///
+    /// \brief getMeasuredRange - get last measured range of X
+    /// \return - pair of beginning and end of range
+    ///
+    std::pair<double, double> getMeasuredRange();
+
+    ///
+    /// \brief getReadout - get samples of visible graphs nearest to cursor, updated with cursor grid values
+    /// \return - sample of each graph, sorted by id of graph, empty if readout and snap are disabled
+    ///
+    const std::vector<SampleReadout> &getReadout();
+
+    ///
+    /// \brief getPickedGraph - get graph picked by last click
+    /// \return - id of graph, -1 if no graph is under cursor
+    ///
+    int getPickedGraph();
+
+    ///
+    /// \brief getHoveredGraph - get graph under cursor picked while mouse moves
+    /// \return - id of graph, -1 if no graph is under cursor
+    ///
+    int getHoveredGraph();
+
+    // --- Measurement ---
+
+    ///
+    /// \brief measureRange - count statistics of all graphs in range of X and report them by signal. Minimum and
+    /// maximum are taken from levels of detail, mean and RMS from prefix sums, only edges of range are scanned,
+    /// so cost doesn't depend on number of samples in range
+    /// \param begin - beginning of range
+    /// \param end - end of range
+    ///
+    void measureRange(double begin, double end);
+
+    // --- Picking ---
+
+    ///
+    /// \brief pickGraph - find graph drawn nearest to point. Graphs are drawn with their ids in offscreen buffer only
+    /// when view or graphs are changed, query reads small neighbourhood of point
+    /// \param point - point in widget plane
+    /// \return - id of graph, -1 if no graph is near point
+    ///
+    int pickGraph(QPoint point);
+
 private:
 
     // --- Event methods ---
@@ -328,6 +724,11 @@ private:
     ///
     QPoint coordGLtoWD(QPointF point);
 
+    ///
+    /// \brief applyCamera - load projection and view transform of camera
+    ///
+    void applyCamera();
+
     ///
     /// \brief resetScene - dropping zoom and indentation
     ///
@@ -349,97 +750,413 @@ private:
     ///
     void updateGrid(bool updateFullGrid);
 
+    ///
+    /// \brief fillGrid - place lines of grid along one axis only around view, so their number doesn't depend on zoom
+    /// \param lines - where coordinates of lines are written, lines of coarser grid go first
+    /// \param base - coordinate through which grid passes
+    /// \param step - distance between lines
+    /// \param min - beginning of covered range
+    /// \param max - end of covered range
+    /// \param divided - whether grid is coarser grid divided by ZOOM_FACTOR_GRID
+    ///
+    void fillGrid(std::vector<double> &lines, double base, double step, double min, double max, bool divided);
+
     ///
     /// \brief updateGL - update GL border
     ///
     void updateGLBorder();
 
-private:
+    ///
+    /// \brief refreshScene - refit scene if it's updated auto and repaint, deferred while widget is suspended
+    ///
+    void refreshScene();
 
-    // --- Helper structs ---
+    ///
+    /// \brief scheduleRefresh - refresh scene once in next pass of event loop, results of building of several graphs
+    /// are applied together
+    ///
+    void scheduleRefresh();
 
     ///
-    /// \brief The MOUSE_MOVE_MODE enum - mouse movement mode
+    /// \brief isDeferred - whether widget only records changes (it's suspended or transaction is open)
+    /// \return - true if changes are deferred
     ///
-    enum class MOUSE_MOVE_MODE : int {
-        UNDEFINED = -1,
-        START, ///< Mouse press left button
-        ZOOM,
-        RESET
-    };
+    bool isDeferred();
 
-    // --- Fields ---
+    ///
+    /// \brief flushPending - build recorded values and update scene, when widget isn't deferred anymore
+    ///
+    void flushPending();
 
-    int                                    m_id; ///< External widget id
-    bool                                 m_init; ///<
-    bool                      m_updateSceneAuto; ///<
+    ///
+    /// \brief drawHud - draw performance overlay over scene
+    ///
+    void drawHud();
 
-    WidgetSignals                     *m_signal; ///< Object class Signals
+    ///
+    /// \brief drawReadout - draw markers of samples nearest to cursor and their values
+    ///
+    void drawReadout();
 
-    std::unordered_map<int, GraphData> m_graphs; ///< Data for each graph
+    ///
+    /// \brief updateReadout - find sample of each visible graph nearest to cursor and snap cursor grid
+    ///
+    void updateReadout();
 
-    std::pair<double, double>      m_zoomFactor; ///< Current scene zoom factor X, Y = first, second
-    std::pair<double, double>  m_lastZoomFactor; ///< Previous scene zoom factor X, Y = first, second
-    std::pair<double, double>          m_offset; ///< Current shift along axes X, Y = first, second
+    ///
+    /// \brief nearestSample - find sample of graph nearest to X, by index for evenly spaced samples,
+    /// else by binary search
+    /// \param data - data of graph
+    /// \param x - coordinate X
+    /// \param readout - found sample
+    /// \return - false if graph has no samples
+    ///
+    bool nearestSample(const GraphData &data, double x, SampleReadout &readout);
 
-    std::pair<int, int>                m_WDSize; ///< Current Widget size X, Y = first, second
-    std::pair<double, double>    m_pixelDencity; ///< Pixel density along axes  X, Y = first, second
-    std::pair<double, double>       m_pixelSize; ///< Pixel sizes in scene measure
-    std::pair<double, double>       m_sceneSize; ///< Scene size X, Y = first, second
+    ///
+    /// \brief drawGraph - draw graph in current color by way suitable for its data
+    /// \param idGraph - id of graph
+    /// \param data - data of graph
+    ///
+    void drawGraph(int idGraph, const GraphData &data);
 
-    std::pair<double, double>         m_MinMaxX; ///< Minimum and maximum values of X
-    std::pair<type, type>             m_MinMaxY; ///< Minimum and maximum values of Y
-    QPointF                       m_borderMaxGL; ///< Max scene border, right upper corner
-    QPointF                       m_borderMinGL; ///< Max scene border, left lower corner
+    ///
+    /// \brief drawPick - draw visible graphs with their ids in buffer of picking, context must be current
+    /// \return - false if buffer of picking isn't supported
+    ///
+    bool drawPick();
 
-    QPoint                     m_lastMousePosWD; ///< Previous cursor position in widget plane
-    QPoint                     m_currMousePosWD; ///< Current cursor position in widget plane
-    QPointF                    m_lastMousePosGL; ///< Previous cursor position in GL plane
-    QPointF                    m_currMousePosGL; ///< Current cursor position in GL plane
+    ///
+    /// \brief vertex - submit vertex relative to origin of camera, so it stays exact in float at any zoom
+    /// \param x - coordinate X
+    /// \param y - coordinate Y
+    ///
+    void vertex(double x, double y);
 
-    QPointF                m_selectedSceneBegin; ///< Start point of discharge
-    QPointF                  m_selectedSceneEnd; ///< End point of discharge
-    QPointF                 m_saveSelectedBegin; ///< Point when pressing left mouse button
+    ///
+    /// \brief drawSamples - submit raw samples in current graph mode
+    /// \param values - samples
+    /// \param count - number of samples
+    /// \param start - coordinate X of first sample
+    /// \param step - distance between each value on graph
+    ///
+    void drawSamples(const type *values, size_t count, double start, double step);
 
-    std::vector<float>        m_gridHorizontalY; ///< Coord of horizontal grid
-    std::vector<float>          m_gridVerticalX; ///< Coord of vertical grid
+    ///
+    /// \brief drawSource - draw visible part of graph source, from levels of detail when samples are denser than pixels
+    /// \param idGraph - id of graph
+    /// \param data - graph with source
+    ///
+    void drawSource(int idGraph, const GraphData &data);
 
-    std::vector<int>          m_textHorizontalY; ///< Coord of values for horizontal grid
-    std::vector<int>            m_textVerticalX; ///< Coord of values for vertical grid
-    std::vector<double>        m_valueHorizontalY; ///< Values for horizontal grid
-    std::vector<double>          m_valueVerticalX; ///< Values for vertical grid
+    ///
+    /// \brief drawGraphLevels - draw visible part of graph from its levels of detail when samples are denser than pixels
+    /// \param idGraph - id of graph
+    /// \param data - graph with levels of detail
+    /// \return - false if graph should be drawn from its values
+    ///
+    bool drawGraphLevels(int idGraph, const GraphData &data);
 
-    type                            m_stepGraph; ///< Distance between each value on graph
-    std::pair<double, double>        m_stepGrid; ///< Distance between each part of the grid, XY
-    std::pair<double, double>  m_staticStepGrid; ///< Static distance between each part of the grid, XY
-    bool                             m_showGrid; ///< Whether grid is shown
-    bool                       m_showGridCursor; ///< Whether cursor grid is shown
+    ///
+    /// \brief refineLevel - choose level of detail drawn in this frame, it goes to needed level one step per frame
+    /// while paint time is in refinement budget
+    /// \param idGraph - id of graph
+    /// \param target - needed level of detail, -1 is raw samples
+    /// \param levelCount - number of levels of graph
+    /// \return - drawn level of detail, -1 is raw samples
+    ///
+    int refineLevel(int idGraph, int target, size_t levelCount);
 
-    std::pair<QPointF, QPointF>          m_axes; ///< Pair point in coordinate system OpenGL, left lower corner,
-    ///< right upper corner
+    ///
+    /// \brief samplesPerPixel - number of visible samples in one pixel, scaled up when quality is lowered
+    /// \param first - index of first visible sample
+    /// \param last - index after last visible sample
+    /// \return - number of samples in one pixel
+    ///
+    double samplesPerPixel(size_t first, size_t last);
 
-    QRgb                            m_colorBack; ///< Background color
-    QRgb                            m_colorGrid; ///< Grid color
-    QRgb                      m_colorGridCursor; ///< Cursor grid color
-    QRgb                            m_colorAxes; ///< Axes color
+    ///
+    /// \brief updateQuality - count frame time and change quality level by it
+    ///
+    void updateQuality();
 
-    float                          m_widthGraph; ///< Graph line width
-    float                           m_widthGrid; ///< Grid line width
-    float                     m_widthGridCursor; ///< Cursor grid line width
-    float                           m_widthAxes; ///< Axes line width
+    ///
+    /// \brief setQualityLevel - set quality level and notify about its change
+    /// \param level - quality level
+    ///
+    void setQualityLevel(int level);
 
-    GRAPH_MODE                      m_graphMode; ///< Mode in which graph will display
-    SCENE_MODE                      m_sceneMode; ///< Mode in which scene will change
-    SCENE_MODE                m_staticSceneMode; ///< Mode in which scene will change by default
-    MOUSE_MOVE_MODE             m_mouseMoveMode; ///< Mouse movement mode
-    Qt::MouseButton                m_moveButton; ///<
-    Qt::MouseButton                m_zoomButton; ///<
+    ///
+    /// \brief drawEnvelope - submit minimum and maximum of each bucket of level in range of samples
+    /// \param pyramid - levels of detail
+    /// \param level - level of detail
+    /// \param first - index of first sample
+    /// \param last - index after last sample
+    /// \param start - coordinate X of first sample of graph
+    /// \param step - distance between each value on graph
+    ///
+    void drawEnvelope(const MinMaxPyramid<type> &pyramid, int level, size_t first, size_t last, double start,
+                      double step);
+
+    ///
+    /// \brief visibleRange - range of samples of graph visible in widget
+    /// \param size - number of samples of graph
+    /// \param start - coordinate X of first sample
+    /// \param step - distance between each value on graph
+    /// \param first - index of first visible sample
+    /// \param last - index after last visible sample
+    /// \return - false if no sample is visible
+    ///
+    bool visibleRange(size_t size, double start, double step, size_t &first, size_t &last);
+
+    ///
+    /// \brief visibleRangeX - range of samples of graph with own X visible in widget, found by binary search
+    /// \param data - data of graph
+    /// \param size - number of samples of graph
+    /// \param first - index of first visible sample
+    /// \param last - index after last visible sample
+    /// \return - false if no sample is visible
+    ///
+    bool visibleRangeX(const GraphData &data, size_t size, size_t &first, size_t &last);
+
+    ///
+    /// \brief drawGraphX - draw graph with own X, samples denser than pixels are reduced to minimum and maximum of
+    /// each pixel column, which are taken from levels of detail
+    /// \param idGraph - id of graph
+    /// \param data - data of graph
+    ///
+    void drawGraphX(int idGraph, const GraphData &data);
+
+    ///
+    /// \brief drawSamplesX - submit raw samples of graph with own X in current graph mode
+    /// \param data - data of graph
+    /// \param first - index of first sample
+    /// \param last - index after last sample
+    /// \param size - number of samples of graph
+    ///
+    void drawSamplesX(const GraphData &data, size_t first, size_t last, size_t size);
+
+    ///
+    /// \brief drawScatter - draw cloud of points, cells of index outside view are skipped and dense cells are
+    /// subsampled to number of points which their pixels can show
+    /// \param idGraph - id of graph
+    /// \param data - data of graph
+    ///
+    void drawScatter(int idGraph, const GraphData &data);
+
+    ///
+    /// \brief drawWaterfall - draw history of waterfall, oldest row at bottom
+    /// \param data - data of graph
+    ///
+    void drawWaterfall(const GraphData &data);
+
+    ///
+    /// \brief primitive - primitive of graph in current graph mode
+    /// \return - points in scatter mode, else line strip
+    ///
+    GLenum primitive() const;
+
+    ///
+    /// \brief buildGraph - build levels of detail of graph values in pool by chunks, graph values and levels
+    /// are replaced together when all chunks are done, until then previous version is drawn
+    /// \param idGraph - id of graph
+    /// \param graph - array of graph values
+    ///
+    void buildGraph(int idGraph, std::vector<type> &&graph);
+
+    ///
+    /// \brief applyGraph - replace graph values and levels of detail, called in GUI thread
+    /// \param idGraph - id of graph
+    /// \param generation - version of graph values
+    /// \param graph - array of graph values
+    /// \param pyramid - levels of detail of graph values
+    /// \param sums - prefix sums of graph values
+    ///
+    void applyGraph(int idGraph, size_t generation, std::vector<type> &&graph,
+                    std::shared_ptr<const MinMaxPyramid<type>> pyramid, std::shared_ptr<const RangeSums<type>> sums,
+                    quint64 hash);
+
+    ///
+    /// \brief measureGraph - count statistics of samples of graph in range of X
+    /// \param data - data of graph
+    /// \param begin - beginning of range
+    /// \param end - end of range
+    /// \return - statistics, count is 0 if graph has no samples in range
+    ///
+    RangeStatistics measureGraph(const GraphData &data, double begin, double end);
+
+    ///
+    /// \brief applyScatter - replace index of cloud of points, called in GUI thread
+    /// \param idGraph - id of graph
+    /// \param generation - version of cloud
+    /// \param scatter - index of cloud
+    ///
+    void applyScatter(int idGraph, size_t generation, std::shared_ptr<const ScatterIndex> scatter);
+
+    ///
+    /// \brief drawBuffer - draw range of samples of graph in line or scatter mode from GPU buffer, buffer is uploaded
+    /// when graph is drawn first time with new values
+    /// \param idGraph - id of graph
+    /// \param data - graph
+    /// \param first - index of first sample
+    /// \param last - index after last sample
+    /// \return - false if graph can't be drawn from GPU buffer
+    ///
+    bool drawBuffer(int idGraph, const GraphData &data, size_t first, size_t last);
+
+    ///
+    /// \brief releaseBuffer - drop reference of graph to its GPU buffer
+    /// \param idGraph - id of graph
+    ///
+    void releaseBuffer(int idGraph);
+
+private:
+
+    // --- Helper structs ---
+
+    ///
+    /// \brief The MOUSE_MOVE_MODE enum - mouse movement mode
+    ///
+    enum class MOUSE_MOVE_MODE : int {
+        UNDEFINED = -1,
+        START, ///< Mouse press left button
+        ZOOM,
+        RESET
+    };
+
+    ///
+    /// \brief The RefineState struct - progressive rendering of graph
+    ///
+    struct RefineState {
+        int  target; ///< Needed level of detail, -1 is raw samples
+        int   level; ///< Drawn level of detail
+    };
+
+    // --- Fields ---
+
+    int                                    m_id; ///< External widget id
+    bool                                 m_init; ///<
+    bool                      m_updateSceneAuto; ///<
+
+    WidgetSignals                     *m_signal; ///< Object class Signals
+
+    std::unordered_map<int, GraphData> m_graphs; ///< Data for each graph
+
+    Camera                             m_camera; ///< View of scene
+    std::pair<double, double>  m_lastZoomFactor; ///< Previous scene zoom factor X, Y = first, second
+
+    QPoint                     m_lastMousePosWD; ///< Previous cursor position in widget plane
+    QPoint                     m_currMousePosWD; ///< Current cursor position in widget plane
+    QPointF                    m_lastMousePosGL; ///< Previous cursor position in GL plane
+    QPointF                    m_currMousePosGL; ///< Current cursor position in GL plane
+
+    QPointF                m_selectedSceneBegin; ///< Start point of discharge
+    QPointF                  m_selectedSceneEnd; ///< End point of discharge
+    QPointF                 m_saveSelectedBegin; ///< Point when pressing left mouse button
+
+    std::vector<double>       m_gridHorizontalY; ///< Coord of horizontal grid
+    std::vector<double>         m_gridVerticalX; ///< Coord of vertical grid
+    QRectF                         m_gridWindow; ///< Part of scene covered by lines of grid
+
+    std::vector<int>          m_textHorizontalY; ///< Coord of values for horizontal grid
+    std::vector<int>            m_textVerticalX; ///< Coord of values for vertical grid
+    std::vector<double>        m_valueHorizontalY; ///< Values for horizontal grid
+    std::vector<double>          m_valueVerticalX; ///< Values for vertical grid
+
+    type                            m_stepGraph; ///< Distance between each value on graph
+    std::pair<double, double>        m_stepGrid; ///< Distance between each part of the grid, XY
+    std::pair<double, double>  m_staticStepGrid; ///< Static distance between each part of the grid, XY
+    bool                             m_showGrid; ///< Whether grid is shown
+    bool                       m_showGridCursor; ///< Whether cursor grid is shown
+
+    std::pair<QPointF, QPointF>          m_axes; ///< Pair point in coordinate system OpenGL, left lower corner,
+    ///< right upper corner
+
+    QRgb                            m_colorBack; ///< Background color
+    QRgb                            m_colorGrid; ///< Grid color
+    QRgb                      m_colorGridCursor; ///< Cursor grid color
+    QRgb                            m_colorAxes; ///< Axes color
+
+    float                          m_widthGraph; ///< Graph line width
+    float                           m_widthGrid; ///< Grid line width
+    float                     m_widthGridCursor; ///< Cursor grid line width
+    float                           m_widthAxes; ///< Axes line width
+
+    GRAPH_MODE                      m_graphMode; ///< Mode in which graph will display
+    SCENE_MODE                      m_sceneMode; ///< Mode in which scene will change
+    SCENE_MODE                m_staticSceneMode; ///< Mode in which scene will change by default
+    MOUSE_MOVE_MODE             m_mouseMoveMode; ///< Mouse movement mode
+    Qt::MouseButton                m_moveButton; ///<
+    Qt::MouseButton                m_zoomButton; ///<
     Qt::Key                  m_resetSceneButton; ///<
     Qt::Key                m_cancelSelectButton; ///<
     Qt::Key                    m_verticalButton; ///<
     Qt::Key                  m_horizontalButton; ///<
     Qt::KeyboardModifier     m_verticalModifier; ///<
     Qt::KeyboardModifier   m_horizontalModifier; ///<
+
+    FrameTiming                   m_frameTiming; ///< Measurements of frame phases
+    std::array<QOpenGLTimerQuery *, GPU_TIMER_QUERIES> m_timerQueries; ///< Ring of GPU timer queries
+    std::array<bool, GPU_TIMER_QUERIES> m_timerQueriesPending; ///< Whether query waits for reading of result
+    bool                             m_gpuTimer; ///< Whether GPU timer queries available
+    size_t                         m_frameCount; ///< Number of painted frames
+
+    RenderCounters             m_renderCounters; ///< Counters of rendering
+    QElapsedTimer                    m_hudTimer; ///< Timer of FPS and uploaded bytes counting
+    size_t                          m_hudFrames; ///< Frames painted since last counting
+    size_t                           m_hudBytes; ///< Bytes transferred since last counting
+    bool                              m_showHud; ///< Whether performance overlay is shown
+    std::vector<type>             m_sourceValues; ///< Buffer for samples read from graph sources
+    Qt::Key                         m_hudButton; ///<
+    double                        m_frameBudget; ///< Budget of frame time in milliseconds, 0 is disabled
+
+    TaskPool                        *m_taskPool; ///< Pool in which levels of detail are built, may be nullptr
+    TaskGroup                      m_taskGroup; ///< Unfinished tasks of widget
+    std::shared_ptr<GpuBufferCache> m_bufferCache; ///< GPU buffers shared in context group
+    std::unordered_map<int, quint64> m_graphBuffers; ///< Key of GPU buffer referenced by each graph
+
+    bool                            m_suspended; ///< Whether widget is in hidden tab
+    bool                         m_resetPending; ///< Whether scene should be refitted when widget is shown
+    bool                        m_borderPending; ///< Whether GL border and grid should be updated when widget is shown
+    std::unordered_map<int, std::vector<type>> m_pendingValues; ///< Last values of each graph set while suspended
+    std::unordered_map<int, size_t> m_buildingGenerations; ///< Version of values of each graph being built in pool
+    int                           m_updateDepth; ///< Number of open transactions
+    bool                     m_refreshScheduled; ///< Whether refresh of scene is queued
+    size_t                         m_generation; ///< Last version of graph values
+
+    QElapsedTimer                  m_paintTimer; ///< Timer of current frame
+    double                       m_refineBudget; ///< Budget of frame time for refinement in milliseconds, 0 is disabled
+    std::unordered_map<int, RefineState> m_refineStates; ///< Progressive rendering of each graph
+    bool                              m_refined; ///< Whether all graphs reached needed level of detail
+    bool                         m_frameRefined; ///< Whether current frame draws all graphs at needed level
+
+    double                      m_qualityTarget; ///< Target of frame time in milliseconds, 0 is disabled governor
+    int                          m_qualityLevel; ///< Current quality level, 0 is full quality
+    size_t                      m_qualityFrames; ///< Frames counted since last change of quality
+    double                        m_qualityTime; ///< Sum of frame time since last change of quality
+    QTimer                          m_idleTimer; ///< Restores full quality when widget is idle
+    bool                         m_antialiasing; ///< Whether graph lines are antialiased at full quality
+
+    DensityBuffer                     m_density; ///< Hits of graphs in intensity mode
+    bool                          m_densityMode; ///< Whether graphs are drawn as intensity
+    Camera                      m_densityCamera; ///< Camera of last intensity frame, hits are dropped when it changes
+
+    bool                          m_measureMode; ///< Whether selection measures graphs instead of zooming
+    std::pair<double, double>    m_measuredRange; ///< Last measured range of X
+    std::unordered_map<int, RangeStatistics> m_rangeStatistics; ///< Statistics of graphs in last measured range
+
+    bool                          m_showReadout; ///< Whether values of samples nearest to cursor are shown
+    bool                           m_cursorSnap; ///< Whether cursor grid snaps to nearest sample
+    std::vector<SampleReadout>        m_readout; ///< Samples of visible graphs nearest to cursor
+    QPointF                          m_cursorGL; ///< Position of cursor grid in GL plane, sample when snapped
+
+    PickBuffer                           m_pick; ///< Ids of graphs drawn offscreen
+    Camera                         m_pickCamera; ///< Camera of buffer of picking
+    bool                            m_pickValid; ///< Whether buffer of picking shows current graphs
+    bool                              m_picking; ///< Whether click picks graph
+    bool                          m_pickOnHover; ///< Whether mouse move picks graph
+    int                           m_pickedGraph; ///< Graph picked by last click, -1 is none
+    int                          m_hoveredGraph; ///< Graph under cursor, -1 is none
 };
 
 template<typename type, TYPE_VISIBLE T>
@@ -451,9 +1168,7 @@ OpenGLWidget<type, T>::OpenGLWidget(int id, QWidget *parent)
 
     setMouseTracking(true);
 
-    // Border
-    m_MinMaxX = {0, 1};
-    m_MinMaxY = {0, 1};
+    m_signal = nullptr;
 
     m_lastZoomFactor = {1, 1};
     m_stepGraph = 1;
@@ -486,40 +1201,250 @@ OpenGLWidget<type, T>::OpenGLWidget(int id, QWidget *parent)
 
     m_graphs.reserve(10);
 
+    m_timerQueries.fill(nullptr);
+    m_timerQueriesPending.fill(false);
+    m_gpuTimer = false;
+    m_frameCount = 0;
+
+    m_hudFrames = 0;
+    m_hudBytes = 0;
+    m_showHud = false;
+    m_hudButton = Qt::Key::Key_F3;
+    m_frameBudget = 0;
+
+    m_taskPool = nullptr;
+    m_generation = 0;
+    m_bufferCache = std::make_shared<GpuBufferCache>();
+
+    m_suspended = false;
+    m_resetPending = false;
+    m_borderPending = false;
+    m_updateDepth = 0;
+    m_refreshScheduled = false;
+
+    m_refineBudget = REFINE_BUDGET_MS;
+    m_refined = true;
+    m_frameRefined = true;
+
+    m_qualityTarget = 0;
+    m_qualityLevel = 0;
+    m_qualityFrames = 0;
+    m_qualityTime = 0;
+    m_antialiasing = false;
+    m_densityMode = false;
+    m_measureMode = false;
+    m_measuredRange = {0, 0};
+    m_showReadout = false;
+    m_cursorSnap = false;
+    m_pickValid = false;
+    m_picking = false;
+    m_pickOnHover = false;
+    m_pickedGraph = -1;
+    m_hoveredGraph = -1;
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(QUALITY_IDLE_MS);
+    connect(&m_idleTimer, &QTimer::timeout, this, [this]() {
+        if (m_qualityLevel > 0) {
+            setQualityLevel(0);
+            update();
+        }
+    });
+
     resetScene();
 }
 
 template<typename type, TYPE_VISIBLE T>
-void OpenGLWidget<type, T>::addGraph(int idGraph, GraphData &graph)
+OpenGLWidget<type, T>::~OpenGLWidget()
+{
+    // Tasks post their results to widget
+    m_taskGroup.wait();
+
+    for (auto &graph : m_graphs)
+        if (graph.second.source)
+            graph.second.source->setPyramidCallback(nullptr);
+
+    // Timer queries and buffers must be destroyed in their context
+    if (m_init) {
+        makeCurrent();
+        for (auto &query : m_timerQueries)
+            delete query;
+        for (auto &buffer : m_graphBuffers)
+            m_bufferCache->release(buffer.second);
+        m_bufferCache->collect();
+        m_density.destroy();
+        m_pick.destroy();
+        for (auto &graph : m_graphs)
+            if (graph.second.waterfall)
+                graph.second.waterfall->destroy();
+        doneCurrent();
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::addGraph(int idGraph, GraphData graph)
 {
+    FrameTiming::ScopedTimer timer{m_frameTiming, FRAME_PHASE::DATA_UPLOAD};
+    TRACE_SPAN("addGraph");
+
+    // Values are shown after they're built, graph keeps no copy of them until then
+    std::vector<type> values = std::move(graph.graph);
     m_graphs[idGraph] = graph;
-    if (m_updateSceneAuto)
-        resetScene();
-    update();
+    m_graphs[idGraph].generation = m_generation;
+    if (graph.source) {
+        // Levels of detail come from background pass, refit scene when they are published
+        graph.source->setPyramidCallback([this]() {
+            QMetaObject::invokeMethod(this, [this]() {
+                refreshScene();
+            }, Qt::QueuedConnection);
+        });
+    } else if (isDeferred()) {
+        m_pendingValues[idGraph] = std::move(values);
+    } else {
+        buildGraph(idGraph, std::move(values));
+        return;
+    }
+    refreshScene();
 }
 
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::setValuesGraph(int idGraph, const std::vector<type> &graph)
 {
-    m_graphs[idGraph].graph = graph;
-    if (m_updateSceneAuto)
-        resetScene();
+    FrameTiming::ScopedTimer timer{m_frameTiming, FRAME_PHASE::DATA_UPLOAD};
+    TRACE_SPAN("setValuesGraph");
+
+    if (m_graphs.find(idGraph) == m_graphs.end())
+        return;
+
+    // Only last values of deferred graph are kept
+    if (isDeferred())
+        m_pendingValues[idGraph] = graph;
+    else
+        buildGraph(idGraph, std::vector<type>{graph});
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setValuesGraph(int idGraph, const std::vector<type> &graph, const std::vector<double> &x)
+{
+    auto found = m_graphs.find(idGraph);
+    if (found == m_graphs.end())
+        return;
+
+    // Until new values are built only samples with both value and X are drawn
+    found->second.x = x;
+    setValuesGraph(idGraph, graph);
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setPointsGraph(int idGraph, std::vector<double> x, std::vector<double> y)
+{
+    FrameTiming::ScopedTimer timer{m_frameTiming, FRAME_PHASE::DATA_UPLOAD};
+    TRACE_SPAN("setPointsGraph");
+
+    if (m_graphs.find(idGraph) == m_graphs.end())
+        return;
+
+    size_t generation = ++m_generation;
+    bool async = m_taskPool != nullptr;
+    auto build = [this, idGraph, generation, async, x = std::move(x), y = std::move(y)]() {
+        TRACE_SPAN("build scatter index");
+
+        auto scatter = std::make_shared<ScatterIndex>();
+        scatter->build(x, y);
+
+        if (async) {
+            QMetaObject::invokeMethod(this, [this, idGraph, generation, scatter]() {
+                applyScatter(idGraph, generation, scatter);
+            }, Qt::QueuedConnection);
+        } else {
+            applyScatter(idGraph, generation, scatter);
+        }
+    };
+
+    if (async)
+        m_taskPool->submit(std::move(build), &m_taskGroup);
+    else
+        build();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::addRowsGraph(int idGraph, const float *values, size_t count)
+{
+    FrameTiming::ScopedTimer timer{m_frameTiming, FRAME_PHASE::DATA_UPLOAD};
+    TRACE_SPAN("addRowsGraph");
+
+    auto found = m_graphs.find(idGraph);
+    if (found == m_graphs.end() || !found->second.waterfall)
+        return;
+
+    // Scene is fitted to first rows, later rows only repaint
+    bool first = found->second.waterfall->total() == 0;
+    found->second.waterfall->addRows(values, count);
+    if (first)
+        refreshScene();
+    else
+        update();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setLevelsGraph(int idGraph, std::pair<double, double> levels)
+{
+    auto found = m_graphs.find(idGraph);
+    if (found == m_graphs.end() || !found->second.waterfall)
+        return;
+
+    found->second.waterfall->setLevels(levels);
+    update();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setColormapGraph(int idGraph, const std::vector<QRgb> &colors)
+{
+    auto found = m_graphs.find(idGraph);
+    if (found == m_graphs.end() || !found->second.waterfall)
+        return;
+
+    found->second.waterfall->setColormap(colors);
     update();
 }
 
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setRowStepGraph(int idGraph, double step)
+{
+    auto found = m_graphs.find(idGraph);
+    if (found == m_graphs.end() || !found->second.waterfall)
+        return;
+
+    found->second.waterfall->setRowStep(step);
+    refreshScene();
+}
+
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::deleteGraph(int idGraph)
 {
+    auto graph = m_graphs.find(idGraph);
+    if (graph != m_graphs.end() && graph->second.source)
+        graph->second.source->setPyramidCallback(nullptr);
+
+    // Texture of waterfall must be destroyed in its context
+    if (m_init && graph != m_graphs.end() && graph->second.waterfall) {
+        makeCurrent();
+        graph->second.waterfall->destroy();
+        doneCurrent();
+    }
+
+    releaseBuffer(idGraph);
     m_graphs.erase(idGraph);
-    if (m_updateSceneAuto)
-        resetScene();
-    update();
+    m_refineStates.erase(idGraph);
+    m_pendingValues.erase(idGraph);
+    m_buildingGenerations.erase(idGraph);
+    refreshScene();
 }
 
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::setGraphVisible(int idGraph, bool show)
 {
     m_graphs[idGraph].show = show;
+    m_pickValid = false;
     update();
 }
 
@@ -529,12 +1454,57 @@ bool OpenGLWidget<type, T>::existsGraph(int idGraph)
     return m_graphs.find(idGraph) != m_graphs.end();
 }
 
+template<typename type, TYPE_VISIBLE T>
+bool OpenGLWidget<type, T>::samplesGraph(int idGraph, bool visible, size_t &generation, size_t &first, type *out,
+                                         size_t &count)
+{
+    // Only graphs with values in memory and evenly spaced samples
+    auto found = m_graphs.find(idGraph);
+    if (found == m_graphs.end())
+        return false;
+
+    const GraphData &data = found->second;
+    if (data.graph.empty() || data.source || !data.x.empty() || data.scatter || data.waterfall)
+        return false;
+
+    size_t begin{}, end = data.graph.size();
+    if (visible && !visibleRange(data.graph.size(), data.startPoint, m_stepGraph, begin, end))
+        return false;
+
+    begin = end - std::min(count, end - begin);
+    if (data.generation == generation && begin == first)
+        return false;
+
+    std::copy(data.graph.begin() + begin, data.graph.begin() + end, out);
+    generation = data.generation;
+    first = begin;
+    count = end - begin;
+
+    return true;
+}
+
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::updateScene()
 {
     resetScene();
 }
 
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::beginUpdate()
+{
+    ++m_updateDepth;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::endUpdate()
+{
+    if (m_updateDepth == 0)
+        return;
+
+    --m_updateDepth;
+    flushPending();
+}
+
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::swapMouseButton()
 {
@@ -555,6 +1525,13 @@ void OpenGLWidget<type, T>::setGridCursorVisible(bool show)
     update();
 }
 
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setHudVisible(bool show)
+{
+    m_showHud = show;
+    update();
+}
+
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::setUpdateSceneAuto(bool set)
 {
@@ -567,18 +1544,47 @@ void OpenGLWidget<type, T>::setSignal(WidgetSignals *signal)
     m_signal = signal;
 }
 
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setTaskPool(TaskPool *pool)
+{
+    m_taskPool = pool;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setBufferCache(std::shared_ptr<GpuBufferCache> cache)
+{
+    for (auto &buffer : m_graphBuffers)
+        m_bufferCache->release(buffer.second);
+    m_graphBuffers.clear();
+
+    m_bufferCache = std::move(cache);
+    update();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setSuspended(bool set)
+{
+    if (m_suspended == set)
+        return;
+
+    m_suspended = set;
+    flushPending();
+}
+
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::setStartPointGraph(int idGraph, double startPoint)
 {
     m_graphs[idGraph].startPoint = startPoint;
+    m_pickValid = false;
     update();
 }
 
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::setStepGraph(double step)
 {
-    m_sceneSize.first = m_sceneSize.first / m_stepGraph * step;
+    m_camera.sceneSize.first = m_camera.sceneSize.first / m_stepGraph * step;
     m_stepGraph = step;
+    m_pickValid = false;
     update();
 }
 
@@ -596,15 +1602,15 @@ void OpenGLWidget<type, T>::setStepGrid(std::pair<double, double> step)
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::setMinMaxXScene(double minX, double maxX)
 {
-    m_MinMaxX = {minX, maxX};
-    m_zoomFactor.first = 1;
+    m_camera.minMaxX = {minX, maxX};
+    m_camera.zoom.first = 1;
     m_lastZoomFactor.first = 1;
-    m_offset.first = 0;
+    m_camera.offset.first = 0;
 
-    m_sceneSize.first = m_MinMaxX.second - m_MinMaxX.first;
+    m_camera.sceneSize.first = m_camera.minMaxX.second - m_camera.minMaxX.first;
 
     if (m_staticStepGrid.first <= 0)
-        m_stepGrid.first = m_sceneSize.first / DEFAULT_STEP_GRID;
+        m_stepGrid.first = m_camera.sceneSize.first / DEFAULT_STEP_GRID;
 
     updateGLBorder();
 }
@@ -612,15 +1618,15 @@ void OpenGLWidget<type, T>::setMinMaxXScene(double minX, double maxX)
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::setMinMaxYScene(double minY, double maxY)
 {
-    m_MinMaxY = {minY, maxY};
-    m_zoomFactor.second = 1;
+    m_camera.minMaxY = {minY, maxY};
+    m_camera.zoom.second = 1;
     m_lastZoomFactor.second = 1;
-    m_offset.second = 0;
+    m_camera.offset.second = 0;
 
-    m_sceneSize.second = m_MinMaxY.second - m_MinMaxY.first;
+    m_camera.sceneSize.second = m_camera.minMaxY.second - m_camera.minMaxY.first;
 
     if (m_staticStepGrid.second <= 0)
-        m_stepGrid.second = m_sceneSize.second / DEFAULT_STEP_GRID;
+        m_stepGrid.second = m_camera.sceneSize.second / DEFAULT_STEP_GRID;
 
     updateGLBorder();
 }
@@ -629,6 +1635,7 @@ template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::setGraphMode(GRAPH_MODE mode)
 {
     m_graphMode = mode;
+    m_pickValid = false;
     update();
 }
 
@@ -653,52 +1660,155 @@ void OpenGLWidget<type, T>::setCancelSelectButton(Qt::Key button)
 }
 
 template<typename type, TYPE_VISIBLE T>
-void OpenGLWidget<type, T>::swapVHButtons()
+void OpenGLWidget<type, T>::setFrameBudget(double ms)
 {
-    std::swap(m_verticalButton, m_horizontalButton);
-    std::swap(m_verticalModifier, m_horizontalModifier);
+    m_frameBudget = ms;
 }
 
 template<typename type, TYPE_VISIBLE T>
-void OpenGLWidget<type, T>::setColorGraph(int idGraph, QRgb color)
+void OpenGLWidget<type, T>::setRefineBudget(double ms)
 {
-    m_graphs[idGraph].color = color;
+    m_refineBudget = ms;
     update();
 }
 
-
 template<typename type, TYPE_VISIBLE T>
-void OpenGLWidget<type, T>::setColorBack(QRgb color)
+void OpenGLWidget<type, T>::setQualityTarget(double ms)
 {
-    m_colorBack = color;
+    m_qualityTarget = ms;
+    m_qualityFrames = 0;
+    m_qualityTime = 0;
+    if (ms <= 0)
+        setQualityLevel(0);
     update();
 }
 
 template<typename type, TYPE_VISIBLE T>
-void OpenGLWidget<type, T>::setColorGrid(QRgb color)
+void OpenGLWidget<type, T>::setAntialiasing(bool set)
 {
-    m_colorGrid = color;
+    m_antialiasing = set;
     update();
 }
 
 template<typename type, TYPE_VISIBLE T>
-void OpenGLWidget<type, T>::setColorGridCursor(QRgb color)
+void OpenGLWidget<type, T>::setDensityMode(bool set)
 {
-    m_colorGridCursor = color;
+    m_densityMode = set;
+    m_densityCamera = Camera{};
     update();
 }
 
 template<typename type, TYPE_VISIBLE T>
-void OpenGLWidget<type, T>::setColorAxes(QRgb color)
+void OpenGLWidget<type, T>::setDensityDecay(double decay)
 {
-    m_colorAxes = color;
+    m_density.setDecay(decay);
     update();
 }
 
 template<typename type, TYPE_VISIBLE T>
-void OpenGLWidget<type, T>::setWidthGraph(float width)
+void OpenGLWidget<type, T>::setDensitySaturation(double hits)
+{
+    m_density.setSaturation(hits);
+    update();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setDensityColormap(const std::vector<QRgb> &colors)
+{
+    m_density.setColormap(colors);
+    update();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setReadoutVisible(bool show)
+{
+    m_showReadout = show;
+    updateReadout();
+    update();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setCursorSnap(bool set)
+{
+    m_cursorSnap = set;
+    updateReadout();
+    update();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setPicking(bool set)
+{
+    m_picking = set;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setPickOnHover(bool set)
+{
+    m_pickOnHover = set;
+    if (!set)
+        m_hoveredGraph = -1;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setMeasureMode(bool set)
+{
+    m_measureMode = set;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setHudButton(Qt::Key button)
+{
+    m_hudButton = button;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::swapVHButtons()
+{
+    std::swap(m_verticalButton, m_horizontalButton);
+    std::swap(m_verticalModifier, m_horizontalModifier);
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setColorGraph(int idGraph, QRgb color)
+{
+    m_graphs[idGraph].color = color;
+    update();
+}
+
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setColorBack(QRgb color)
+{
+    m_colorBack = color;
+    update();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setColorGrid(QRgb color)
+{
+    m_colorGrid = color;
+    update();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setColorGridCursor(QRgb color)
+{
+    m_colorGridCursor = color;
+    update();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setColorAxes(QRgb color)
+{
+    m_colorAxes = color;
+    update();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setWidthGraph(float width)
 {
     m_widthGraph = width;
+    m_pickValid = false;
     update();
 }
 
@@ -723,16 +1833,136 @@ void OpenGLWidget<type, T>::setWidthAxes(float width)
     update();
 }
 
+template<typename type, TYPE_VISIBLE T>
+double OpenGLWidget<type, T>::getStepGraph()
+{
+    return m_stepGraph;
+}
+
+template<typename type, TYPE_VISIBLE T>
+double OpenGLWidget<type, T>::getStartPointGraph(int idGraph)
+{
+    auto found = m_graphs.find(idGraph);
+    return found == m_graphs.end() ? 0 : found->second.startPoint;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool OpenGLWidget<type, T>::getValuesGraph(int idGraph, std::vector<type> &values)
+{
+    auto found = m_graphs.find(idGraph);
+    if (found == m_graphs.end())
+        return false;
+
+    if (!hasValuesGraph(idGraph))
+        return false;
+
+    // Newest values are pending or built in pool
+    auto pending = m_pendingValues.find(idGraph);
+    if (pending != m_pendingValues.end()) {
+        values = pending->second;
+        return true;
+    }
+    if (m_buildingGenerations.count(idGraph))
+        return false;
+
+    values = found->second.graph;
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool OpenGLWidget<type, T>::hasValuesGraph(int idGraph)
+{
+    auto found = m_graphs.find(idGraph);
+    if (found == m_graphs.end())
+        return false;
+
+    const GraphData &data = found->second;
+
+    return !data.source && data.x.empty() && !data.scatter && !data.waterfall;
+}
+
+template<typename type, TYPE_VISIBLE T>
+const std::unordered_map<int, typename OpenGLWidget<type, T>::RangeStatistics> &OpenGLWidget<type, T>::getRangeStatistics()
+{
+    return m_rangeStatistics;
+}
+
+template<typename type, TYPE_VISIBLE T>
+std::pair<double, double> OpenGLWidget<type, T>::getMeasuredRange()
+{
+    return m_measuredRange;
+}
+
+template<typename type, TYPE_VISIBLE T>
+const std::vector<typename OpenGLWidget<type, T>::SampleReadout> &OpenGLWidget<type, T>::getReadout()
+{
+    return m_readout;
+}
+
+template<typename type, TYPE_VISIBLE T>
+int OpenGLWidget<type, T>::getPickedGraph()
+{
+    return m_pickedGraph;
+}
+
+template<typename type, TYPE_VISIBLE T>
+int OpenGLWidget<type, T>::getHoveredGraph()
+{
+    return m_hoveredGraph;
+}
+
+template<typename type, TYPE_VISIBLE T>
+int OpenGLWidget<type, T>::pickGraph(QPoint point)
+{
+    TRACE_SPAN("pickGraph");
+
+    if (!m_init || isDeferred())
+        return -1;
+
+    // Buffer is drawn again only after change of view or graphs
+    makeCurrent();
+    int result{-1};
+    if ((m_pickValid && m_camera.sameView(m_pickCamera)) || drawPick()) {
+        double ratio = devicePixelRatioF();
+        result = m_pick.pick(static_cast<int>(point.x() * ratio), static_cast<int>(point.y() * ratio),
+                             static_cast<int>(std::ceil(PICK_RADIUS * ratio)), defaultFramebufferObject());
+    }
+    doneCurrent();
+
+    return result;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::measureRange(double begin, double end)
+{
+    TRACE_SPAN("measureRange");
+
+    if (begin > end)
+        std::swap(begin, end);
+
+    m_measuredRange = {begin, end};
+    m_rangeStatistics.clear();
+    for (const auto &graph : m_graphs) {
+        RangeStatistics statistics = measureGraph(graph.second, begin, end);
+        if (statistics.count)
+            m_rangeStatistics[graph.first] = statistics;
+    }
+
+    if (m_signal)
+        m_signal->triggerSignalRangeStatistics(m_id);
+}
+
 template<typename type, TYPE_VISIBLE T>
 std::pair<double, double> OpenGLWidget<type, T>::getMinMaxXScene()
 {
-    return m_MinMaxX;
+    return m_camera.minMaxX;
 }
 
 template<typename type, TYPE_VISIBLE T>
 std::pair<type, type> OpenGLWidget<type, T>::getMinMaxYScene()
 {
-    return m_MinMaxY;
+    return {static_cast<type>(m_camera.minMaxY.first), static_cast<type>(m_camera.minMaxY.second)};
 }
 
 template<typename type, TYPE_VISIBLE T>
@@ -747,6 +1977,39 @@ std::pair<std::vector<double> &, std::vector<double> &> OpenGLWidget<type, T>::g
     return {m_valueVerticalX, m_valueHorizontalY};
 }
 
+template<typename type, TYPE_VISIBLE T>
+FrameStatistics OpenGLWidget<type, T>::getFrameStatistics()
+{
+    FrameStatistics statistics = m_frameTiming.getStatistics();
+    statistics.gpuTimer = m_gpuTimer;
+
+    return statistics;
+}
+
+template<typename type, TYPE_VISIBLE T>
+FrameTiming &OpenGLWidget<type, T>::getFrameTiming()
+{
+    return m_frameTiming;
+}
+
+template<typename type, TYPE_VISIBLE T>
+const typename OpenGLWidget<type, T>::RenderCounters &OpenGLWidget<type, T>::getRenderCounters()
+{
+    return m_renderCounters;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool OpenGLWidget<type, T>::isRefined()
+{
+    return m_refined;
+}
+
+template<typename type, TYPE_VISIBLE T>
+int OpenGLWidget<type, T>::getQualityLevel()
+{
+    return m_qualityLevel;
+}
+
 template<typename type, TYPE_VISIBLE T>
 bool OpenGLWidget<type, T>::eventFilter(QObject *obj, QEvent *event)
 {
@@ -785,6 +2048,8 @@ bool OpenGLWidget<type, T>::eventFilter(QObject *obj, QEvent *event)
             resetScene();
         } else if (keyEvent->key() == m_cancelSelectButton) {
             m_mouseMoveMode = MOUSE_MOVE_MODE::UNDEFINED;
+        } else if (keyEvent->key() == m_hudButton) {
+            m_showHud ^= true;
         }
     }
 
@@ -829,21 +2094,30 @@ void OpenGLWidget<type, T>::mouseReleaseEvent(QMouseEvent *event)
     if (event->button() == m_moveButton) {
         unsetCursor();
     } else if (event->button() == m_zoomButton) {
-        if (m_mouseMoveMode == MOUSE_MOVE_MODE::RESET) {
+        if (m_mouseMoveMode == MOUSE_MOVE_MODE::START && m_picking) {
+            m_pickedGraph = pickGraph(event->pos());
+            if (m_signal)
+                m_signal->triggerSignalGraphPicked(m_id);
+        } else if (m_mouseMoveMode == MOUSE_MOVE_MODE::ZOOM && m_measureMode) {
+            measureRange(m_selectedSceneBegin.x(), m_selectedSceneEnd.x());
+            update();
+        } else if (m_mouseMoveMode == MOUSE_MOVE_MODE::RESET) {
             resetScene();
         } else if (m_mouseMoveMode == MOUSE_MOVE_MODE::ZOOM) {
             if (m_sceneMode <= SCENE_MODE::BOTH &&
-                    (abs(m_sceneSize.first) / abs(m_selectedSceneEnd.x() - m_selectedSceneBegin.x()))
-                    < m_zoomFactor.first * MAX_ZOOM) {
-                m_zoomFactor.first = abs(m_sceneSize.first) / abs(m_selectedSceneEnd.x() - m_selectedSceneBegin.x());
-                m_offset.first += (coordWDtoGL(QPoint{0, 0}).x() - m_selectedSceneBegin.x()) * m_zoomFactor.first;
+                    (abs(m_camera.sceneSize.first) / abs(m_selectedSceneEnd.x() - m_selectedSceneBegin.x()))
+                    < m_camera.zoom.first * MAX_ZOOM) {
+                m_camera.zoom.first = std::min(abs(m_camera.sceneSize.first) / abs(m_selectedSceneEnd.x() - m_selectedSceneBegin.x()),
+                                         MAX_ZOOM_SCENE);
+                m_camera.offset.first += (coordWDtoGL(QPoint{0, 0}).x() - m_selectedSceneBegin.x()) * m_camera.zoom.first;
             }
             if (m_sceneMode >= SCENE_MODE::BOTH &&
-                    (abs(m_sceneSize.second) / abs(m_selectedSceneEnd.y() - m_selectedSceneBegin.y()))
-                    < m_zoomFactor.first * MAX_ZOOM)  {
-                m_zoomFactor.second = abs(m_sceneSize.second) / abs(m_selectedSceneEnd.y() - m_selectedSceneBegin.y());
-                m_offset.second += (coordWDtoGL(QPoint{0, m_WDSize.second / 2}).y()
-                                    - (m_selectedSceneEnd.y() + m_selectedSceneBegin.y()) / 2) * m_zoomFactor.second;
+                    (abs(m_camera.sceneSize.second) / abs(m_selectedSceneEnd.y() - m_selectedSceneBegin.y()))
+                    < m_camera.zoom.first * MAX_ZOOM)  {
+                m_camera.zoom.second = std::min(abs(m_camera.sceneSize.second) / abs(m_selectedSceneEnd.y() - m_selectedSceneBegin.y()),
+                                         MAX_ZOOM_SCENE);
+                m_camera.offset.second += (coordWDtoGL(QPoint{0, m_camera.size.second / 2}).y()
+                                    - (m_selectedSceneEnd.y() + m_selectedSceneBegin.y()) / 2) * m_camera.zoom.second;
             }
 
             updateGrid(false);
@@ -863,13 +2137,20 @@ void OpenGLWidget<type, T>::mouseMoveEvent(QMouseEvent *event)
 
     if (event->buttons() & m_moveButton) {
         if (m_sceneMode <= SCENE_MODE::BOTH)
-            m_offset.first += (m_currMousePosGL.x() - m_lastMousePosGL.x()) * m_zoomFactor.first;
+            m_camera.offset.first += (m_currMousePosGL.x() - m_lastMousePosGL.x()) * m_camera.zoom.first;
         if (m_sceneMode >= SCENE_MODE::BOTH)
-            m_offset.second += (m_currMousePosGL.y() - m_lastMousePosGL.y()) * m_zoomFactor.second;
+            m_camera.offset.second += (m_currMousePosGL.y() - m_lastMousePosGL.y()) * m_camera.zoom.second;
 
         updateBorder();
     } else if (event->buttons() & m_zoomButton && m_mouseMoveMode != MOUSE_MOVE_MODE::UNDEFINED) {
         updateMouseMove();
+    } else if (event->buttons() == Qt::NoButton && m_pickOnHover) {
+        int hovered = pickGraph(m_currMousePosWD);
+        if (hovered != m_hoveredGraph) {
+            m_hoveredGraph = hovered;
+            if (m_signal)
+                m_signal->triggerSignalGraphHovered(m_id);
+        }
     }
 
     updateGrid(false);
@@ -886,20 +2167,24 @@ void OpenGLWidget<type, T>::wheelEvent(QWheelEvent *event)
     m_lastMousePosGL = coordWDtoGL(m_currMousePosWD);
 
     if (m_sceneMode <= SCENE_MODE::BOTH) {
-        m_zoomFactor.first *= delta;
-        if (m_zoomFactor.first < MIN_ZOOM)
-            m_zoomFactor.first = MIN_ZOOM;
+        m_camera.zoom.first *= delta;
+        if (m_camera.zoom.first < MIN_ZOOM)
+            m_camera.zoom.first = MIN_ZOOM;
+        if (m_camera.zoom.first > MAX_ZOOM_SCENE)
+            m_camera.zoom.first = MAX_ZOOM_SCENE;
         m_currMousePosGL = coordWDtoGL(m_currMousePosWD);
-        m_offset.first += (m_currMousePosGL.x() - m_lastMousePosGL.x())
-                          + (m_currMousePosGL.x() - m_lastMousePosGL.x()) * (m_zoomFactor.first - 1);
+        m_camera.offset.first += (m_currMousePosGL.x() - m_lastMousePosGL.x())
+                          + (m_currMousePosGL.x() - m_lastMousePosGL.x()) * (m_camera.zoom.first - 1);
     }
     if (m_sceneMode >= SCENE_MODE::BOTH) {
-        m_zoomFactor.second *= delta;
-        if (m_zoomFactor.second < MIN_ZOOM)
-            m_zoomFactor.second = MIN_ZOOM;
+        m_camera.zoom.second *= delta;
+        if (m_camera.zoom.second < MIN_ZOOM)
+            m_camera.zoom.second = MIN_ZOOM;
+        if (m_camera.zoom.second > MAX_ZOOM_SCENE)
+            m_camera.zoom.second = MAX_ZOOM_SCENE;
         m_currMousePosGL = coordWDtoGL(m_currMousePosWD);
-        m_offset.second += (m_currMousePosGL.y() - m_lastMousePosGL.y())
-                           + (m_currMousePosGL.y() - m_lastMousePosGL.y()) * (m_zoomFactor.second - 1);
+        m_camera.offset.second += (m_currMousePosGL.y() - m_lastMousePosGL.y())
+                           + (m_currMousePosGL.y() - m_lastMousePosGL.y()) * (m_camera.zoom.second - 1);
     }
 
     updateBorder();
@@ -916,185 +2201,180 @@ void OpenGLWidget<type, T>::initializeGL()
     glClearColor(qRed(m_colorBack), qGreen(m_colorBack), qBlue(m_colorBack), 1.0f); // Обновление цвета
     glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST); // Улучшение в вычислении перспективы
 
+    // GPU timer queries, available since OpenGL 3.3 or with GL_ARB_timer_query
+    m_gpuTimer = true;
+    for (auto &query : m_timerQueries) {
+        query = new QOpenGLTimerQuery();
+        m_gpuTimer = m_gpuTimer && query->create();
+    }
+    if (!m_gpuTimer) {
+        for (auto &query : m_timerQueries) {
+            delete query;
+            query = nullptr;
+        }
+    }
+
     m_init = true;
 }
 
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::resizeGL(int w, int h)
 {
-    // Widget size
-    m_WDSize.first = w;
-    m_WDSize.second = h;
-    // Pixel density
-    m_pixelDencity.first = (float)m_WDSize.first / m_sceneSize.first;
-    m_pixelDencity.second = (float)m_WDSize.second / m_sceneSize.second;
-    // Pixel size
-    m_pixelSize.first = m_sceneSize.first / (float)m_WDSize.first / m_zoomFactor.first;
-    m_pixelSize.second = m_sceneSize.second / (float)m_WDSize.second / m_zoomFactor.second;
-    //Border
-    m_borderMaxGL = coordWDtoGL(QPoint{m_WDSize.first * 3 / 2, -m_WDSize.second / 2});
-    m_borderMinGL = coordWDtoGL(QPoint{-m_WDSize.first / 2, m_WDSize.second * 3 / 2});
-
-    glViewport(0, 0, w, h);
-
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    glOrtho(m_MinMaxX.first,
-            m_MinMaxX.second,
-            m_MinMaxY.first,
-            m_MinMaxY.second,
-            1, -1);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
+    m_camera.size = {std::max(w, 1), std::max(h, 1)};
+    m_camera.update();
 }
 
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::paintGL()
 {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glLoadIdentity();
+    TRACE_SPAN("paintGL");
+
+    m_paintTimer.start();
+    m_frameRefined = true;
+
+    // Read result of query issued some frames ago, if it isn't ready the frame is not measured on GPU
+    size_t slot = m_frameCount % GPU_TIMER_QUERIES;
+    QOpenGLTimerQuery *timerQuery = m_timerQueries[slot];
+    if (timerQuery && m_timerQueriesPending[slot]) {
+        if (timerQuery->isResultAvailable()) {
+            m_frameTiming.addSample(FRAME_PHASE::DRAW_GPU, timerQuery->waitForResult() / 1e6);
+            m_timerQueriesPending[slot] = false;
+        } else {
+            timerQuery = nullptr;
+        }
+    }
+    if (timerQuery)
+        timerQuery->begin();
+
+    m_renderCounters.vertices = 0;
+    m_renderCounters.drawCalls = 0;
+    m_renderCounters.samples = 0;
+    m_renderCounters.lodLevels.clear();
+
+    // Buffers released since last frame
+    m_bufferCache->collect();
 
-    glTranslated(m_offset.first, m_offset.second, 0.0);
-    glScalef(m_zoomFactor.first, m_zoomFactor.second, 1.0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    applyCamera();
 
     if (m_showGridCursor) {
         glEnable(GL_LINE_STIPPLE);
         glLineStipple(1, 0x3333);
         glLineWidth(m_widthGridCursor);
         glBegin(GL_LINES);
+        m_renderCounters.vertices += 4;
+        ++m_renderCounters.drawCalls;
         {
             glColor4ub(qRed(m_colorGridCursor), qGreen(m_colorGridCursor), qBlue(m_colorGridCursor), qAlpha(m_colorGridCursor));
-            glVertex2d(m_axes.first.x(), m_currMousePosGL.y());
-            glVertex2d(m_axes.second.x(), m_currMousePosGL.y());
-            glVertex2d(m_currMousePosGL.x(), m_axes.first.y());
-            glVertex2d(m_currMousePosGL.x(), m_axes.second.y());
+            vertex(m_axes.first.x(), m_cursorGL.y());
+            vertex(m_axes.second.x(), m_cursorGL.y());
+            vertex(m_cursorGL.x(), m_axes.first.y());
+            vertex(m_cursorGL.x(), m_axes.second.y());
         }
         glEnd();
         glDisable(GL_LINE_STIPPLE);
     }
 
     if (m_showGrid) {
+        // Lines added by last division of grid are skipped when quality is lowered
+        size_t gridX = m_gridVerticalX.size();
+        size_t gridY = m_gridHorizontalY.size();
+        if (m_qualityLevel >= QUALITY_THIN_GRID) {
+            if (m_lastZoomFactor.first >= ZOOM_FACTOR_GRID)
+                gridX /= ZOOM_FACTOR_GRID;
+            if (m_lastZoomFactor.second >= ZOOM_FACTOR_GRID)
+                gridY /= ZOOM_FACTOR_GRID;
+        }
+
         // Vertical grid
         glLineWidth(m_widthGrid);
         glBegin(GL_LINES);
+        m_renderCounters.vertices += 2 * (gridX + gridY);
+        ++m_renderCounters.drawCalls;
         glColor4ub(qRed(m_colorGrid), qGreen(m_colorGrid), qBlue(m_colorGrid), qAlpha(m_colorGrid));
-        for (size_t i = 0; i < m_gridVerticalX.size(); i++) {
-            glVertex2d(m_gridVerticalX[i], m_borderMaxGL.y());
-            glVertex2d(m_gridVerticalX[i], m_borderMinGL.y());
+        for (size_t i = 0; i < gridX; i++) {
+            vertex(m_gridVerticalX[i], m_camera.borderMax.y());
+            vertex(m_gridVerticalX[i], m_camera.borderMin.y());
         }
         // Horizontal grid
-        for (size_t i = 0; i < m_gridHorizontalY.size(); i++) {
-            glVertex2d(m_borderMaxGL.x(), m_gridHorizontalY[i]);
-            glVertex2d(m_borderMinGL.x(), m_gridHorizontalY[i]);
+        for (size_t i = 0; i < gridY; i++) {
+            vertex(m_camera.borderMax.x(), m_gridHorizontalY[i]);
+            vertex(m_camera.borderMin.x(), m_gridHorizontalY[i]);
         }
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         glEnd();
     }
 
+    bool antialiasing = m_antialiasing && m_qualityLevel < QUALITY_NO_ANTIALIASING;
+    if (antialiasing) {
+        glEnable(GL_LINE_SMOOTH);
+        glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
+        glEnable(GL_POINT_SMOOTH);
+        glHint(GL_POINT_SMOOTH_HINT, GL_NICEST);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+
+    // Waterfalls are drawn under graphs and aren't part of intensity
+    for (const auto &graph : m_graphs) {
+        if (graph.second.waterfall && graph.second.show)
+            drawWaterfall(graph.second);
+    }
+
+    // Hits of previous frames are valid only for same view
+    bool density = m_densityMode && m_density.begin(!m_camera.sameView(m_densityCamera));
+    m_densityCamera = m_camera;
+    auto color = [density](QRgb rgb) {
+        if (!density)
+            glColor4ub(qRed(rgb), qGreen(rgb), qBlue(rgb), qAlpha(rgb));
+    };
+
     glLineWidth(m_widthGraph);
+    glPointSize(SCATTER_POINT_SIZE * m_widthGraph);
     for (const auto &graph : m_graphs) {
         const auto &data = graph.second;
-        if (data.show == false)
+        m_renderCounters.samples += data.source ? data.source->size()
+                                                : data.scatter ? data.scatter->size()
+                                                : data.waterfall ? data.waterfall->shownRows() * data.waterfall->width()
+                                                : data.graph.size();
+        if (data.show == false || data.waterfall)
             continue;
 
-        glColor4ub(qRed(data.color), qGreen(data.color), qBlue(data.color), qAlpha(data.color));
-        glBegin(GL_LINE_STRIP);
-        {
-            if (m_graphMode == GRAPH_MODE::LINE) {
-                type start = data.startPoint;
-                if constexpr(T == TYPE_VISIBLE::SHORT) {
-                    for (size_t i = 0; i < data.graph.size(); ++i, start += m_stepGraph) {
-                        glVertex2s(start, data.graph[i]);
-                    }
-                } else if constexpr(T == TYPE_VISIBLE::INT) {
-                    for (size_t i = 0; i < data.graph.size(); ++i, start += m_stepGraph) {
-                        glVertex2i(start, data.graph[i]);
-                    }
-                } else if constexpr(T == TYPE_VISIBLE::FLOAT) {
-                    for (size_t i = 0; i < data.graph.size(); ++i, start += m_stepGraph) {
-                        glVertex2f(start, data.graph[i]);
-                    }
-                } else if constexpr(T == TYPE_VISIBLE::DOUBLE) {
-                    for (size_t i = 0; i < data.graph.size(); ++i, start += m_stepGraph) {
-                        glVertex2d(start, data.graph[i]);
-                    }
-                }
-            } else if (m_graphMode == GRAPH_MODE::COLUMN) {
-                type start = data.startPoint;
-                if constexpr(T == TYPE_VISIBLE::SHORT) {
-                    for (size_t i = 0; i < data.graph.size(); ++i) {
-                        glVertex2s(start, data.graph[i]);
-                        start += m_stepGraph;
-                        glVertex2s(start, data.graph[i]);
-                    }
-                } else if constexpr(T == TYPE_VISIBLE::INT) {
-                    for (size_t i = 0; i < data.graph.size(); ++i) {
-                        glVertex2i(start, data.graph[i]);
-                        start += m_stepGraph;
-                        glVertex2i(start, data.graph[i]);
-                    }
-                } else if constexpr(T == TYPE_VISIBLE::FLOAT) {
-                    for (size_t i = 0; i < data.graph.size(); ++i) {
-                        glVertex2f(start, data.graph[i]);
-                        start += m_stepGraph;
-                        glVertex2f(start, data.graph[i]);
-                    }
-                } else if constexpr(T == TYPE_VISIBLE::DOUBLE) {
-                    for (size_t i = 0; i < data.graph.size(); ++i) {
-                        glVertex2d(start, data.graph[i]);
-                        start += m_stepGraph;
-                        glVertex2d(start, data.graph[i]);
-                    }
-                }
-            } else if (m_graphMode == GRAPH_MODE::RECTANGLE) {
-                type start = data.startPoint - m_stepGraph / 2;
-                if constexpr(T == TYPE_VISIBLE::SHORT) {
-                    for (size_t i = 0; i < data.graph.size(); ++i) {
-                        glVertex2s(start, data.graph[i]);
-                        start += m_stepGraph;
-                        glVertex2s(start, data.graph[i]);
-                    }
-                } else if constexpr(T == TYPE_VISIBLE::INT) {
-                    for (size_t i = 0; i < data.graph.size(); ++i) {
-                        glVertex2i(start, data.graph[i]);
-                        start += m_stepGraph;
-                        glVertex2i(start, data.graph[i]);
-                    }
-                } else if constexpr(T == TYPE_VISIBLE::FLOAT) {
-                    for (size_t i = 0; i < data.graph.size(); ++i) {
-                        glVertex2f(start, data.graph[i]);
-                        start += m_stepGraph;
-                        glVertex2f(start, data.graph[i]);
-                    }
-                } else if constexpr(T == TYPE_VISIBLE::DOUBLE) {
-                    for (size_t i = 0; i < data.graph.size(); ++i) {
-                        glVertex2d(start, data.graph[i]);
-                        start += m_stepGraph;
-                        glVertex2d(start, data.graph[i]);
-                    }
-                }
-            }
-        }
-        glEnd();
+        color(data.color);
+        drawGraph(graph.first, data);
+    }
+
+    if (antialiasing) {
+        glDisable(GL_LINE_SMOOTH);
+        glDisable(GL_POINT_SMOOTH);
+        glDisable(GL_BLEND);
+    }
+    glPointSize(1);
+
+    if (density) {
+        ++m_renderCounters.drawCalls;
+        m_density.end(defaultFramebufferObject(), m_colorBack);
     }
 
     if (m_mouseMoveMode != MOUSE_MOVE_MODE::UNDEFINED) {
         glColor4ub(128, 128, 128, 255);
         glLineWidth(1);
         glBegin(GL_LINE_LOOP);
+        m_renderCounters.vertices += 4;
+        ++m_renderCounters.drawCalls;
         {
             glEnable(GL_LINE_STIPPLE);
             glLineStipple(1, 0x3333);
             if (m_mouseMoveMode == MOUSE_MOVE_MODE::ZOOM) {
                 // Selection rectangle
-                glVertex2d(m_selectedSceneBegin.x(), m_selectedSceneBegin.y());
-                glVertex2d(m_selectedSceneBegin.x(), m_selectedSceneEnd.y());
-                glVertex2d(m_selectedSceneEnd.x(), m_selectedSceneEnd.y());
-                glVertex2d(m_selectedSceneEnd.x(), m_selectedSceneBegin.y());
+                vertex(m_selectedSceneBegin.x(), m_selectedSceneBegin.y());
+                vertex(m_selectedSceneBegin.x(), m_selectedSceneEnd.y());
+                vertex(m_selectedSceneEnd.x(), m_selectedSceneEnd.y());
+                vertex(m_selectedSceneEnd.x(), m_selectedSceneBegin.y());
             } else if (m_mouseMoveMode == MOUSE_MOVE_MODE::RESET) {
                 // Reset line
-                glVertex2d(m_selectedSceneBegin.x(), m_selectedSceneBegin.y());
-                glVertex2d(m_selectedSceneEnd.x(), m_selectedSceneEnd.y());
+                vertex(m_selectedSceneBegin.x(), m_selectedSceneBegin.y());
+                vertex(m_selectedSceneEnd.x(), m_selectedSceneEnd.y());
             }
             glDisable(GL_LINE_STIPPLE);
         }
@@ -1106,11 +2386,13 @@ void OpenGLWidget<type, T>::paintGL()
             glEnable(GL_BLEND);
             glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
             glBegin(GL_QUADS);
+            m_renderCounters.vertices += 4;
+            ++m_renderCounters.drawCalls;
             {
-                glVertex2d(m_selectedSceneBegin.x(), m_selectedSceneBegin.y());
-                glVertex2d(m_selectedSceneBegin.x(), m_selectedSceneEnd.y());
-                glVertex2d(m_selectedSceneEnd.x(), m_selectedSceneEnd.y());
-                glVertex2d(m_selectedSceneEnd.x(), m_selectedSceneBegin.y());
+                vertex(m_selectedSceneBegin.x(), m_selectedSceneBegin.y());
+                vertex(m_selectedSceneBegin.x(), m_selectedSceneEnd.y());
+                vertex(m_selectedSceneEnd.x(), m_selectedSceneEnd.y());
+                vertex(m_selectedSceneEnd.x(), m_selectedSceneBegin.y());
             }
             glEnd();
         }
@@ -1119,110 +2401,1104 @@ void OpenGLWidget<type, T>::paintGL()
     glLineWidth(m_widthAxes);
     glColor4ub(qRed(m_colorAxes), qGreen(m_colorAxes), qBlue(m_colorAxes), qAlpha(m_colorAxes));
     glBegin(GL_LINES);
+    m_renderCounters.vertices += 4;
+    ++m_renderCounters.drawCalls;
     {
         //axis Y
-        glVertex2d(m_axes.first.x(), m_axes.first.y());
-        glVertex2d(m_axes.first.x(), m_axes.second.y());
+        vertex(m_axes.first.x(), m_axes.first.y());
+        vertex(m_axes.first.x(), m_axes.second.y());
         //axis X
-        glVertex2d(m_axes.first.x(), m_axes.second.y());
-        glVertex2d(m_axes.second.x(), m_axes.second.y());
+        vertex(m_axes.first.x(), m_axes.second.y());
+        vertex(m_axes.second.x(), m_axes.second.y());
     }
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glEnd();
-}
 
-template<typename type, TYPE_VISIBLE T>
-QPointF OpenGLWidget<type, T>::coordWDtoGL(QPoint point)
-{
-    QPointF result;
-    result.setX((point.x() / m_pixelDencity.first - m_offset.first) / m_zoomFactor.first + m_MinMaxX.first);
-    result.setY((m_MinMaxY.second - point.y() / m_pixelDencity.second - m_offset.second) / m_zoomFactor.second);
+    if (timerQuery) {
+        timerQuery->end();
+        m_timerQueriesPending[slot] = true;
+    }
 
-    return result;
+    m_frameTiming.addSample(FRAME_PHASE::PAINT, m_paintTimer.nsecsElapsed() / 1e6);
+
+    m_renderCounters.frameTime = m_frameTiming.getLastSample(FRAME_PHASE::PAINT);
+    updateQuality();
+    ++m_hudFrames;
+    if (!m_hudTimer.isValid()) {
+        m_hudTimer.start();
+    } else if (m_hudTimer.elapsed() >= HUD_UPDATE_MS) {
+        double seconds = m_hudTimer.restart() / 1000.0;
+        m_renderCounters.fps = m_hudFrames / seconds;
+        m_renderCounters.uploadedBytes = m_hudBytes / seconds;
+        m_hudFrames = 0;
+        m_hudBytes = 0;
+    }
+
+    if (m_showReadout && !m_readout.empty())
+        drawReadout();
+    if (m_showHud)
+        drawHud();
+
+    // Next level of refinement is drawn in next frame, so interaction isn't blocked
+    if (!m_frameRefined)
+        update();
+    else if (!m_refined && m_signal)
+        m_signal->triggerSignalRefinementFinished(m_id);
+    m_refined = m_frameRefined;
+
+    if (++m_frameCount % FRAME_STATISTICS_PERIOD == 0 && m_signal) {
+        m_signal->triggerSignalFrameStatistics(m_id);
+
+        if (m_frameBudget > 0) {
+            FrameStatistics statistics = m_frameTiming.getStatistics();
+            if (statistics[FRAME_PHASE::PAINT].p95 > m_frameBudget
+                    || statistics[FRAME_PHASE::DRAW_GPU].p95 > m_frameBudget)
+                m_signal->triggerSignalFrameBudget(m_id);
+        }
+    }
 }
 
 template<typename type, TYPE_VISIBLE T>
-QPoint OpenGLWidget<type, T>::coordGLtoWD(QPointF point)
+void OpenGLWidget<type, T>::drawHud()
 {
-    QPoint result;
-    result.setX((point.x() * m_zoomFactor.first - m_MinMaxX.first + m_offset.first) * m_pixelDencity.first);
-    result.setY(m_WDSize.second - (point.y() * m_zoomFactor.second - m_MinMaxY.first + m_offset.second) * m_pixelDencity.second);
+    QStringList lines;
+    lines << QString("FPS: %1").arg(m_renderCounters.fps, 0, 'f', 1);
+
+    FrameStatistics statistics = getFrameStatistics();
+    QString frame = QString("Frame: %1 ms").arg(m_renderCounters.frameTime, 0, 'f', 2);
+    if (statistics.gpuTimer)
+        frame += QString(", GPU: %1 ms").arg(m_frameTiming.getLastSample(FRAME_PHASE::DRAW_GPU), 0, 'f', 2);
+    lines << frame;
+
+    lines << QString("Vertices: %1 / samples: %2").arg(m_renderCounters.vertices).arg(m_renderCounters.samples);
+    lines << QString("Draw calls: %1").arg(m_renderCounters.drawCalls);
+    lines << QString("Upload: %1 MB/s").arg(m_renderCounters.uploadedBytes / (1024 * 1024), 0, 'f', 2);
+    lines << QString("GPU buffers: %1, %2 MB").arg(m_bufferCache->count())
+          .arg(m_bufferCache->memorySize() / (1024.0 * 1024), 0, 'f', 2);
+    lines << QString("Refinement: %1").arg(m_refined ? "done" : "in progress");
+    if (m_qualityTarget > 0)
+        lines << QString("Quality level: %1 / %2").arg(m_qualityLevel).arg(QUALITY_LEVELS - 1);
+
+    int count{};
+    for (const auto &graph : m_graphs) {
+        if (count++ == HUD_MAX_GRAPHS) {
+            lines << QString("... %1 more").arg(m_graphs.size() - HUD_MAX_GRAPHS);
+            break;
+        }
 
-    return result;
+        auto lod = m_renderCounters.lodLevels.find(graph.first);
+        if (!graph.second.show || lod == m_renderCounters.lodLevels.end())
+            lines << QString("Graph %1: hidden").arg(graph.first);
+        else
+            lines << QString("Graph %1: LOD %2").arg(graph.first).arg(lod->second);
+    }
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+
+    QFontMetrics metrics = painter.fontMetrics();
+    int lineHeight = metrics.height();
+    int widthText{};
+    for (const auto &line : lines)
+        widthText = std::max(widthText, metrics.horizontalAdvance(line));
+
+    QRect rect{5, 5, widthText + 10, lineHeight * lines.size() + 10};
+    painter.fillRect(rect, QColor(0, 0, 0, 160));
+    painter.setPen(Qt::white);
+    for (int i = 0; i < lines.size(); ++i)
+        painter.drawText(rect.left() + 5, rect.top() + 5 + metrics.ascent() + i * lineHeight, lines[i]);
+
+    painter.end();
 }
 
 template<typename type, TYPE_VISIBLE T>
-void OpenGLWidget<type, T>::resetScene()
+void OpenGLWidget<type, T>::drawGraph(int idGraph, const GraphData &data)
 {
-    m_zoomFactor = {1, 1};
-    m_lastZoomFactor = {1, 1};
-    m_offset = {0, 0};
-    m_lastMousePosWD = {0, 0};
-    m_currMousePosWD = {0, 0};
-    m_lastMousePosGL = {0, 0};
-    m_currMousePosGL = {0, 0};
+    if (data.source) {
+        drawSource(idGraph, data);
+        return;
+    }
+    if (data.scatter) {
+        drawScatter(idGraph, data);
+        return;
+    }
+    if (!data.x.empty()) {
+        drawGraphX(idGraph, data);
+        return;
+    }
+    if (drawGraphLevels(idGraph, data))
+        return;
 
-    if (m_graphs.empty())
+    // Levels of detail aren't built yet, only visible samples are drawn
+    size_t first, last;
+    if (m_stepGraph <= 0 || !visibleRange(data.graph.size(), data.startPoint, m_stepGraph, first, last))
         return;
 
-    bool first{false};
+    m_renderCounters.lodLevels[idGraph] = 0;
+    ++m_renderCounters.drawCalls;
 
-    for (auto &graph : m_graphs) {
-        const auto &data = graph.second;
-        if (data.show == false)
-            continue;
+    glBegin(primitive());
+    drawSamples(data.graph.data() + first, last - first, data.startPoint + first * m_stepGraph, m_stepGraph);
+    glEnd();
+}
 
-        if (!first) {
-            m_MinMaxX.first = m_MinMaxX.second = data.startPoint;
-            m_MinMaxY.first = m_MinMaxY.second = data.graph[0];
-            first = true;
-        }
+template<typename type, TYPE_VISIBLE T>
+bool OpenGLWidget<type, T>::drawPick()
+{
+    TRACE_SPAN("drawPick");
 
-        if (data.startPoint < m_MinMaxX.first)
-            m_MinMaxX.first = data.startPoint;
+    if (!m_pick.begin())
+        return false;
 
-        type endPoint = data.startPoint + data.graph.size() * m_stepGraph;
-        if (endPoint > m_MinMaxX.second)
-            m_MinMaxX.second = endPoint;
+    // Graphs are drawn at needed level of detail at once, counters and refinement of frames aren't affected
+    RenderCounters counters = m_renderCounters;
+    double refineBudget = m_refineBudget;
+    m_refineBudget = 0;
 
-        m_MinMaxY.first = std::min(*std::min_element(data.graph.begin(), data.graph.end()), m_MinMaxY.first);
-        m_MinMaxY.second = std::max(*std::max_element(data.graph.begin(), data.graph.end()), m_MinMaxY.second);
+    applyCamera();
+    glLineWidth(m_widthGraph);
+    glPointSize(SCATTER_POINT_SIZE * m_widthGraph);
+    for (const auto &graph : m_graphs) {
+        if (!graph.second.show || graph.second.waterfall)
+            continue;
+
+        PickBuffer::setId(graph.first);
+        drawGraph(graph.first, graph.second);
     }
+    glPointSize(1);
+    m_pick.end(defaultFramebufferObject(), m_colorBack);
 
-    m_sceneSize.first = m_MinMaxX.second - m_MinMaxX.first;
-    m_sceneSize.second = m_MinMaxY.second - m_MinMaxY.first;
+    m_refineBudget = refineBudget;
+    m_renderCounters = std::move(counters);
+    m_pickCamera = m_camera;
+    m_pickValid = true;
 
-    if (m_sceneSize.first == 0)
-        m_sceneSize.first = 1;
-    if (m_sceneSize.second == 0)
-        m_sceneSize.second = 1;
+    return true;
+}
 
-    if (m_staticStepGrid.first <= 0)
-        m_stepGrid.first = m_sceneSize.first / DEFAULT_STEP_GRID;
-    if (m_staticStepGrid.second <= 0)
-        m_stepGrid.second = m_sceneSize.second / DEFAULT_STEP_GRID;
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::drawReadout()
+{
+    // Graph may be deleted since readout was updated
+    auto colorGraph = [this](int idGraph) {
+        auto found = m_graphs.find(idGraph);
+        return found == m_graphs.end() ? m_colorGridCursor : found->second.color;
+    };
 
-    if (m_init)
-        updateGLBorder();
+    glPointSize(READOUT_MARKER_SIZE);
+    glBegin(GL_POINTS);
+    ++m_renderCounters.drawCalls;
+    for (const auto &readout : m_readout) {
+        QRgb color = colorGraph(readout.idGraph);
+        glColor4ub(qRed(color), qGreen(color), qBlue(color), 255);
+        vertex(readout.x, readout.value);
+    }
+    glEnd();
+    glPointSize(1);
+    m_renderCounters.vertices += m_readout.size();
+
+    QStringList lines;
+    lines << QString("X: %1").arg(m_cursorGL.x(), 0, 'g', 10);
+    size_t shown = std::min<size_t>(m_readout.size(), READOUT_MAX_GRAPHS);
+    for (size_t i = 0; i < shown; ++i)
+        lines << QString("Graph %1: %2").arg(m_readout[i].idGraph).arg(static_cast<double>(m_readout[i].value), 0, 'g', 10);
+    if (m_readout.size() > shown)
+        lines << QString("... %1 more").arg(m_readout.size() - shown);
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+
+    QFontMetrics metrics = painter.fontMetrics();
+    int lineHeight = metrics.height();
+    int widthText{};
+    for (const auto &line : lines)
+        widthText = std::max(widthText, metrics.horizontalAdvance(line));
+
+    // Box follows cursor and stays inside widget, each value is marked by color of its graph
+    QRect rect{0, 0, widthText + lineHeight + 15, lineHeight * lines.size() + 10};
+    QPoint cursor = coordGLtoWD(m_cursorGL);
+    rect.moveTo(std::clamp(cursor.x() + 15, 0, std::max(0, width() - rect.width())),
+                std::clamp(cursor.y() + 15, 0, std::max(0, height() - rect.height())));
+    painter.fillRect(rect, QColor(0, 0, 0, 160));
+    painter.setPen(Qt::white);
+    for (int i = 0; i < lines.size(); ++i) {
+        int top = rect.top() + 5 + i * lineHeight;
+        if (i > 0 && static_cast<size_t>(i) <= shown)
+            painter.fillRect(rect.left() + 5, top + 2, lineHeight - 4, lineHeight - 4,
+                             QColor{colorGraph(m_readout[i - 1].idGraph)});
+        painter.drawText(rect.left() + lineHeight + 10, top + metrics.ascent(), lines[i]);
+    }
+
+    painter.end();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::updateReadout()
+{
+    m_readout.clear();
+    m_cursorGL = m_currMousePosGL;
+    if (!m_showReadout && !m_cursorSnap)
+        return;
+
+    // Snapped sample is nearest to cursor in pixels, not in scene measure
+    QPoint cursor = coordGLtoWD(m_currMousePosGL);
+    int nearest = CURSOR_SNAP_PIXELS * CURSOR_SNAP_PIXELS;
+    for (const auto &graph : m_graphs) {
+        const GraphData &data = graph.second;
+        SampleReadout readout{graph.first};
+        if (!data.show || data.scatter || data.waterfall || !nearestSample(data, m_currMousePosGL.x(), readout))
+            continue;
+
+        m_readout.push_back(readout);
+        if (m_cursorSnap) {
+            QPoint point = coordGLtoWD({readout.x, static_cast<double>(readout.value)}) - cursor;
+            int distance = point.x() * point.x() + point.y() * point.y();
+            if (distance <= nearest) {
+                nearest = distance;
+                m_cursorGL = {readout.x, static_cast<double>(readout.value)};
+            }
+        }
+    }
+
+    std::sort(m_readout.begin(), m_readout.end(), [](const SampleReadout & first, const SampleReadout & second) {
+        return first.idGraph < second.idGraph;
+    });
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool OpenGLWidget<type, T>::nearestSample(const GraphData &data, double x, SampleReadout &readout)
+{
+    if (!data.source && !data.x.empty()) {
+        size_t size = std::min(data.graph.size(), data.x.size());
+        if (size == 0)
+            return false;
+
+        // Nearest of two samples around X
+        auto begin = data.x.begin();
+        size_t index = std::lower_bound(begin, begin + size, x - data.startPoint) - begin;
+        if (index == size || (index > 0 && x - data.startPoint - data.x[index - 1] < data.x[index] - x + data.startPoint))
+            --index;
+
+        readout.index = index;
+        readout.x = data.startPoint + data.x[index];
+        readout.value = data.graph[index];
+
+        return true;
+    }
+
+    size_t size = data.source ? data.source->size() : data.graph.size();
+    double start = data.source ? data.source->startPoint() : data.startPoint;
+    double step = data.source ? data.source->step() : m_stepGraph;
+    if (size == 0 || step <= 0)
+        return false;
+
+    size_t index = static_cast<size_t>(std::clamp(std::round((x - start) / step), 0.0, size - 1.0));
+    if (data.source) {
+        if (!data.source->read(index, 1, m_sourceValues) || m_sourceValues.empty())
+            return false;
+        readout.value = m_sourceValues[0];
+    } else {
+        readout.value = data.graph[index];
+    }
+    readout.index = index;
+    readout.x = start + index * step;
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+inline void OpenGLWidget<type, T>::vertex(double x, double y)
+{
+    glVertex2d(x - m_camera.origin.first, y - m_camera.origin.second);
+
+    // Vertices of immediate mode are transferred each frame, ones of buffers are counted once on upload
+    m_hudBytes += 2 * sizeof(GLdouble);
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::drawSamples(const type *values, size_t count, double start, double step)
+{
+    if (m_graphMode == GRAPH_MODE::LINE || m_graphMode == GRAPH_MODE::SCATTER) {
+        for (size_t i = 0; i < count; ++i)
+            vertex(start + i * step, values[i]);
+        m_renderCounters.vertices += count;
+    } else {
+        if (m_graphMode == GRAPH_MODE::RECTANGLE)
+            start -= step / 2;
+        for (size_t i = 0; i < count; ++i) {
+            vertex(start + i * step, values[i]);
+            vertex(start + (i + 1) * step, values[i]);
+        }
+        m_renderCounters.vertices += 2 * count;
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::drawSource(int idGraph, const GraphData &data)
+{
+    GraphSource<type> &source = *data.source;
+    size_t size = source.size();
+    double start = source.startPoint();
+    double step = source.step();
+    if (size == 0 || step <= 0)
+        return;
+
+    size_t first, last;
+    if (!visibleRange(size, start, step, first, last))
+        return;
+
+    // When raw samples are too many to read, finest loaded level is drawn even if its buckets are wider than pixel
+    // (e.g. chunks of unfinished file)
+    auto pyramid = source.getPyramid();
+    int target = pyramid ? pyramid->chooseLevel(samplesPerPixel(first, last)) : -1;
+    if (pyramid && target < 0 && last - first > SOURCE_MAX_RAW_SAMPLES && pyramid->levelCount() > 0)
+        target = 0;
+    int level = pyramid ? refineLevel(idGraph, target, pyramid->levelCount()) : -1;
+    m_renderCounters.lodLevels[idGraph] = level + 1;
+    ++m_renderCounters.drawCalls;
+
+    glBegin(primitive());
+    if (level >= 0) {
+        drawEnvelope(*pyramid, level, first, last, start, step);
+
+        // Samples not yet covered by background pass
+        first = std::max(first, pyramid->samples());
+    }
+    if (first < last && last - first <= SOURCE_MAX_RAW_SAMPLES && source.read(first, last - first, m_sourceValues))
+        drawSamples(m_sourceValues.data(), m_sourceValues.size(), start + first * step, step);
+    glEnd();
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool OpenGLWidget<type, T>::drawGraphLevels(int idGraph, const GraphData &data)
+{
+    if (!data.pyramid)
+        return false;
+
+    // Graph out of view isn't drawn at all
+    size_t first, last;
+    if (m_stepGraph <= 0 || !visibleRange(data.graph.size(), data.startPoint, m_stepGraph, first, last))
+        return true;
+
+    int level = refineLevel(idGraph, data.pyramid->chooseLevel(samplesPerPixel(first, last)),
+                            data.pyramid->levelCount());
+
+    m_renderCounters.lodLevels[idGraph] = level + 1;
+    ++m_renderCounters.drawCalls;
+
+    if (level < 0 && (m_graphMode == GRAPH_MODE::LINE || m_graphMode == GRAPH_MODE::SCATTER)
+            && drawBuffer(idGraph, data, first, last))
+        return true;
+
+    // Only visible samples are drawn
+    glBegin(primitive());
+    if (level >= 0)
+        drawEnvelope(*data.pyramid, level, first, last, data.startPoint, m_stepGraph);
+    else
+        drawSamples(data.graph.data() + first, last - first, data.startPoint + first * m_stepGraph, m_stepGraph);
+    glEnd();
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+double OpenGLWidget<type, T>::samplesPerPixel(size_t first, size_t last)
+{
+    double result = static_cast<double>(last - first) / std::max(m_camera.size.first, 1);
+
+    // Each quality level from QUALITY_THIN_GRID takes twice coarser level of detail
+    if (m_qualityLevel >= QUALITY_THIN_GRID)
+        result *= 1 << (m_qualityLevel - QUALITY_THIN_GRID + 1);
+
+    return result;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::updateQuality()
+{
+    if (m_qualityTarget <= 0)
+        return;
+
+    m_idleTimer.start();
+
+    // GPU time is known only with timer queries
+    double frameTime = m_renderCounters.frameTime;
+    if (m_gpuTimer)
+        frameTime = std::max(frameTime, m_frameTiming.getLastSample(FRAME_PHASE::DRAW_GPU));
+
+    m_qualityTime += frameTime;
+    if (++m_qualityFrames < QUALITY_CHECK_FRAMES)
+        return;
+
+    double average = m_qualityTime / m_qualityFrames;
+    m_qualityFrames = 0;
+    m_qualityTime = 0;
+
+    if (average > m_qualityTarget && m_qualityLevel + 1 < QUALITY_LEVELS)
+        setQualityLevel(m_qualityLevel + 1);
+    else if (average < m_qualityTarget * QUALITY_RESTORE_RATIO && m_qualityLevel > 0)
+        setQualityLevel(m_qualityLevel - 1);
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::setQualityLevel(int level)
+{
+    if (m_qualityLevel == level)
+        return;
+
+    m_qualityLevel = level;
+    m_qualityFrames = 0;
+    m_qualityTime = 0;
+    if (m_signal)
+        m_signal->triggerSignalQualityChanged(m_id);
+}
+
+template<typename type, TYPE_VISIBLE T>
+int OpenGLWidget<type, T>::refineLevel(int idGraph, int target, size_t levelCount)
+{
+    if (m_refineBudget <= 0 || levelCount == 0)
+        return target;
+
+    int coarse = std::min(target + REFINE_COARSE_LEVELS, static_cast<int>(levelCount) - 1);
+    auto found = m_refineStates.find(idGraph);
+    if (found == m_refineStates.end())
+        found = m_refineStates.emplace(idGraph, RefineState{target, std::max(coarse, target)}).first;
+
+    // Coarser level is drawn at once, finer one is reached step by step
+    RefineState &state = found->second;
+    state.target = target;
+    state.level = std::clamp(state.level, target, std::max(coarse, target));
+
+    if (state.level > target && m_paintTimer.nsecsElapsed() / 1e6 < m_refineBudget)
+        --state.level;
+    if (state.level != target)
+        m_frameRefined = false;
+
+    return state.level;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::drawEnvelope(const MinMaxPyramid<type> &pyramid, int level, size_t first, size_t last,
+                                         double start, double step)
+{
+    // Minimum and maximum of each bucket
+    pyramid.forEachBucket(level, first, last, [&](size_t index, size_t, const auto & bucket) {
+        vertex(start + index * step, bucket.min);
+        vertex(start + index * step, bucket.max);
+    });
+    m_renderCounters.vertices += 2 * (last - first) / pyramid.blockSize(level) + 2;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool OpenGLWidget<type, T>::visibleRange(size_t size, double start, double step, size_t &first, size_t &last)
+{
+    double left = (coordWDtoGL(QPoint{0, 0}).x() - start) / step - 1;
+    double right = (coordWDtoGL(QPoint{m_camera.size.first, 0}).x() - start) / step + 2;
+    first = static_cast<size_t>(std::clamp(left, 0.0, static_cast<double>(size)));
+    last = static_cast<size_t>(std::clamp(right, 0.0, static_cast<double>(size)));
+
+    return first < last;
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool OpenGLWidget<type, T>::visibleRangeX(const GraphData &data, size_t size, size_t &first, size_t &last)
+{
+    double left = coordWDtoGL(QPoint{0, 0}).x() - data.startPoint;
+    double right = coordWDtoGL(QPoint{m_camera.size.first, 0}).x() - data.startPoint;
+
+    // One sample beyond each edge, so lines enter view
+    auto begin = data.x.begin();
+    first = std::lower_bound(begin, begin + size, left) - begin;
+    last = std::upper_bound(begin, begin + size, right) - begin;
+    if (first > 0)
+        --first;
+    if (last < size)
+        ++last;
+
+    return first < last;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::drawGraphX(int idGraph, const GraphData &data)
+{
+    // Values and X may differ in size while new values are built
+    size_t size = std::min(data.graph.size(), data.x.size());
+    size_t first, last;
+    if (!visibleRangeX(data, size, first, last))
+        return;
+
+    ++m_renderCounters.drawCalls;
+
+    glBegin(primitive());
+    if (data.pyramid && data.pyramid->samples() == data.graph.size()
+            && samplesPerPixel(first, last) >= DECIMATE_SAMPLES_PER_PIXEL) {
+        m_renderCounters.lodLevels[idGraph] = 1;
+
+        // Each pixel column is found by binary search, its minimum and maximum by levels of detail
+        double pixel = 1 / (m_camera.pixelDensity.first * m_camera.zoom.first);
+        double left = coordWDtoGL(QPoint{0, 0}).x();
+        auto begin = data.x.begin();
+        for (size_t i = first; i < last;) {
+            double x = data.startPoint + data.x[i];
+            double columnEnd = left + (std::floor((x - left) / pixel) + 1) * pixel;
+            size_t next = std::upper_bound(begin + i, begin + last, columnEnd - data.startPoint) - begin;
+            next = std::max(next, i + 1);
+
+            auto bucket = data.pyramid->rangeMinMax(data.graph.data(), i, next);
+            vertex(x, bucket.min);
+            vertex(x, bucket.max);
+            m_renderCounters.vertices += 2;
+            i = next;
+        }
+    } else {
+        m_renderCounters.lodLevels[idGraph] = 0;
+        drawSamplesX(data, first, last, size);
+    }
+    glEnd();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::drawSamplesX(const GraphData &data, size_t first, size_t last, size_t size)
+{
+    const std::vector<double> &x = data.x;
+    if (m_graphMode == GRAPH_MODE::LINE || m_graphMode == GRAPH_MODE::SCATTER) {
+        for (size_t i = first; i < last; ++i)
+            vertex(data.startPoint + x[i], data.graph[i]);
+        m_renderCounters.vertices += last - first;
+        return;
+    }
+
+    // Column spans to next sample, rectangle spans halfway to neighbours, edge samples take spacing of neighbour
+    for (size_t i = first; i < last; ++i) {
+        double before = i > 0 ? x[i] - x[i - 1] : (i + 1 < size ? x[i + 1] - x[i] : 0);
+        double after = i + 1 < size ? x[i + 1] - x[i] : before;
+        double left = m_graphMode == GRAPH_MODE::RECTANGLE ? x[i] - before / 2 : x[i];
+        double right = m_graphMode == GRAPH_MODE::RECTANGLE ? x[i] + after / 2 : x[i] + after;
+
+        vertex(data.startPoint + left, data.graph[i]);
+        vertex(data.startPoint + right, data.graph[i]);
+    }
+    m_renderCounters.vertices += 2 * (last - first);
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::drawScatter(int idGraph, const GraphData &data)
+{
+    const ScatterIndex &scatter = *data.scatter;
+    QPointF min = coordWDtoGL(QPoint{0, m_camera.size.second});
+    QPointF max = coordWDtoGL(QPoint{m_camera.size.first, 0});
+
+    // Dense cell shows at most its area in pixels at current zoom, coarser quality levels halve it further
+    auto cell = scatter.cellSize();
+    double cellPixels = cell.first * m_camera.pixelDensity.first * m_camera.zoom.first
+                        * cell.second * m_camera.pixelDensity.second * m_camera.zoom.second;
+    double limit = std::max(1.0, cellPixels * SCATTER_POINTS_PER_PIXEL);
+    if (m_qualityLevel >= QUALITY_THIN_GRID)
+        limit = std::max(1.0, std::ldexp(limit, QUALITY_THIN_GRID - 1 - m_qualityLevel));
+    size_t maxPoints = limit < static_cast<double>(scatter.size()) ? static_cast<size_t>(limit) : scatter.size();
+
+    bool subsampled{false};
+    size_t vertices{};
+    ++m_renderCounters.drawCalls;
+
+    // Cell is shuffled, so its beginning is even sample of it
+    glBegin(GL_POINTS);
+    scatter.forEachCell(min.x(), max.x(), min.y(), max.y(), [&](const ScatterIndex::Point *points, size_t count) {
+        if (count > maxPoints) {
+            count = maxPoints;
+            subsampled = true;
+        }
+        for (size_t i = 0; i < count; ++i)
+            vertex(points[i].x, points[i].y);
+        vertices += count;
+    });
+    glEnd();
+
+    m_renderCounters.vertices += vertices;
+    m_renderCounters.lodLevels[idGraph] = subsampled ? 1 : 0;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::drawWaterfall(const GraphData &data)
+{
+    Waterfall &waterfall = *data.waterfall;
+    double newest = waterfall.total() * waterfall.rowStep();
+    double oldest = newest - waterfall.shownRows() * waterfall.rowStep();
+
+    // Transparent colors of colormap show grid
+    GLboolean blend = glIsEnabled(GL_BLEND);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (waterfall.draw({data.startPoint, data.startPoint + waterfall.width() * m_stepGraph}, {oldest, newest},
+                       m_camera.origin)) {
+        m_renderCounters.vertices += 4;
+        ++m_renderCounters.drawCalls;
+    }
+    if (!blend)
+        glDisable(GL_BLEND);
+}
+
+template<typename type, TYPE_VISIBLE T>
+inline GLenum OpenGLWidget<type, T>::primitive() const
+{
+    return m_graphMode == GRAPH_MODE::SCATTER ? GL_POINTS : GL_LINE_STRIP;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::buildGraph(int idGraph, std::vector<type> &&graph)
+{
+    using Pyramid = MinMaxPyramid<type>;
+    using Bucket = typename Pyramid::Bucket;
+    using Sums = typename RangeSums<type>::Sums;
+
+    ///
+    /// \brief The Build struct - state shared by chunks of one building
+    ///
+    struct Build {
+        std::vector<type>          graph; ///< Array of graph values
+        std::vector<Bucket>      buckets; ///< Buckets of finest level, each chunk fills its part
+        std::vector<Sums>           sums; ///< Sums of buckets of finest level, each chunk fills its part
+        std::vector<quint64>      hashes; ///< Hash of each chunk
+        std::atomic<size_t>    remaining; ///< Number of unfinished chunks
+    };
+
+    auto build = std::make_shared<Build>();
+    build->graph = std::move(graph);
+    build->buckets.resize(build->graph.size() / LOD_BASE_BLOCK);
+    build->sums.resize(build->buckets.size());
+
+    size_t chunks = std::max<size_t>(1, (build->graph.size() + LOD_TASK_SAMPLES - 1) / LOD_TASK_SAMPLES);
+    build->hashes.resize(chunks);
+    build->remaining = chunks;
+    size_t generation = ++m_generation;
+    m_buildingGenerations[idGraph] = generation;
+
+    // Last finished chunk builds coarser levels and publishes result
+    bool async = m_taskPool != nullptr;
+    auto finish = [this, idGraph, generation, build, async]() {
+        TRACE_SPAN("build levels of detail");
+
+        size_t full = build->buckets.size() * LOD_BASE_BLOCK;
+        size_t partialCount = build->graph.size() - full;
+        Bucket partial{};
+        if (partialCount)
+            partial = Pyramid::computeBucket(build->graph.data() + full, partialCount);
+
+        auto pyramid = std::make_shared<Pyramid>();
+        pyramid->setBaseLevel(std::move(build->buckets), partial, partialCount);
+        auto sums = std::make_shared<RangeSums<type>>();
+        sums->setBlocks(std::move(build->sums));
+
+        // Graphs which can't be kept in GPU buffer get no hash
+        quint64 hash{};
+        if (!build->graph.empty() && build->graph.size() <= BUFFER_MAX_SAMPLES)
+            hash = std::max<quint64>(1, hashSeries(build->hashes.data(), build->hashes.size() * sizeof(quint64),
+                                                   build->graph.size()));
+
+        if (async) {
+            QMetaObject::invokeMethod(this, [this, idGraph, generation, build, pyramid, sums, hash]() {
+                applyGraph(idGraph, generation, std::move(build->graph), pyramid, sums, hash);
+            }, Qt::QueuedConnection);
+        } else {
+            applyGraph(idGraph, generation, std::move(build->graph), pyramid, sums, hash);
+        }
+    };
+
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        auto task = [build, chunk, finish]() {
+            size_t firstBucket = chunk * LOD_TASK_SAMPLES / LOD_BASE_BLOCK;
+            size_t lastBucket = std::min(build->buckets.size(), (chunk + 1) * LOD_TASK_SAMPLES / LOD_BASE_BLOCK);
+            for (size_t i = firstBucket; i < lastBucket; ++i) {
+                build->buckets[i] = Pyramid::computeBucket(build->graph.data() + i * LOD_BASE_BLOCK, LOD_BASE_BLOCK);
+                build->sums[i] = RangeSums<type>::computeBlock(build->graph.data() + i * LOD_BASE_BLOCK, LOD_BASE_BLOCK);
+            }
+
+            size_t firstSample = std::min(build->graph.size(), chunk * LOD_TASK_SAMPLES);
+            size_t lastSample = std::min(build->graph.size(), (chunk + 1) * LOD_TASK_SAMPLES);
+            build->hashes[chunk] = hashSeries(build->graph.data() + firstSample,
+                                              (lastSample - firstSample) * sizeof(type));
+
+            if (--build->remaining == 0)
+                finish();
+        };
+
+        if (async)
+            m_taskPool->submit(task, &m_taskGroup);
+        else
+            task();
+    }
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::applyGraph(int idGraph, size_t generation, std::vector<type> &&graph,
+                                       std::shared_ptr<const MinMaxPyramid<type>> pyramid,
+                                       std::shared_ptr<const RangeSums<type>> sums, quint64 hash)
+{
+    TRACE_SPAN("applyGraph");
+
+    auto building = m_buildingGenerations.find(idGraph);
+    if (building != m_buildingGenerations.end() && building->second == generation)
+        m_buildingGenerations.erase(building);
+
+    // Graph is deleted or newer values are already shown
+    auto found = m_graphs.find(idGraph);
+    if (found == m_graphs.end() || found->second.generation >= generation)
+        return;
+
+    found->second.graph = std::move(graph);
+    found->second.pyramid = std::move(pyramid);
+    found->second.sums = std::move(sums);
+    found->second.generation = generation;
+    found->second.hash = hash;
+
+    // Results from pool come one by one, scene is refitted once for all of them
+    if (m_taskPool)
+        scheduleRefresh();
+    else
+        refreshScene();
+}
+
+template<typename type, TYPE_VISIBLE T>
+typename OpenGLWidget<type, T>::RangeStatistics OpenGLWidget<type, T>::measureGraph(const GraphData &data, double begin,
+                                                                                     double end)
+{
+    RangeStatistics statistics;
+    if (data.scatter || data.waterfall)
+        return statistics;
+
+    // Samples whose X is in range
+    size_t first{}, last{};
+    if (!data.source && !data.x.empty()) {
+        size_t size = std::min(data.graph.size(), data.x.size());
+        auto x = data.x.begin();
+        first = std::lower_bound(x, x + size, begin - data.startPoint) - x;
+        last = std::upper_bound(x, x + size, end - data.startPoint) - x;
+    } else {
+        double size = data.source ? data.source->size() : data.graph.size();
+        double start = data.source ? data.source->startPoint() : data.startPoint;
+        double step = data.source ? data.source->step() : m_stepGraph;
+        if (step <= 0)
+            return statistics;
+        first = static_cast<size_t>(std::clamp(std::ceil((begin - start) / step), 0.0, size));
+        last = static_cast<size_t>(std::clamp(std::floor((end - start) / step) + 1, 0.0, size));
+    }
+    if (first >= last)
+        return statistics;
+
+    typename MinMaxPyramid<type>::Bucket minMax{};
+    typename RangeSums<type>::Sums sums{};
+    bool known{true};
+
+    if (data.source) {
+        // Only edges are read, middle is taken from levels of detail, short range is read whole
+        auto pyramid = data.source->getPyramid();
+        size_t block = pyramid ? pyramid->blockSize(0) : 1;
+        size_t covered = pyramid && pyramid->levelCount() ? pyramid->level(0).size() * block : 0;
+        size_t head = std::min(last, (first + block - 1) / block * block);
+        size_t tail = std::max(head, std::min(last, covered) / block * block);
+        if (last - first <= SOURCE_MAX_RAW_SAMPLES)
+            head = tail = last;
+        else if ((head - first) + (last - tail) > SOURCE_MAX_RAW_SAMPLES)
+            return statistics;
+
+        bool empty{true};
+        auto add = [&](size_t from, size_t to) {
+            if (from >= to || !data.source->read(from, to - from, m_sourceValues) || m_sourceValues.empty())
+                return;
+            auto bucket = MinMaxPyramid<type>::computeBucket(m_sourceValues.data(), m_sourceValues.size());
+            minMax = empty ? bucket : MinMaxPyramid<type>::combine(minMax, bucket);
+            empty = false;
+            auto edge = RangeSums<type>::computeBlock(m_sourceValues.data(), m_sourceValues.size());
+            sums.sum += edge.sum;
+            sums.squares += edge.squares;
+        };
+        add(first, head);
+        add(tail, last);
+        if (tail > head) {
+            auto middle = pyramid->blocksMinMax(head, tail);
+            minMax = empty ? middle : MinMaxPyramid<type>::combine(minMax, middle);
+            empty = false;
+            known = false;
+        }
+        if (empty)
+            return statistics;
+    } else {
+        // Levels of detail and prefix sums are used only when they are built from shown values
+        const type *values = data.graph.data();
+        bool built = data.pyramid && data.pyramid->samples() == data.graph.size() && data.sums
+                && data.sums->samples() == data.graph.size() / LOD_BASE_BLOCK * LOD_BASE_BLOCK;
+        minMax = built ? data.pyramid->rangeMinMax(values, first, last)
+                       : MinMaxPyramid<type>::computeBucket(values + first, last - first);
+        sums = built ? data.sums->rangeSums(values, first, last)
+                     : RangeSums<type>::computeBlock(values + first, last - first);
+    }
+
+    statistics.count = last - first;
+    statistics.min = minMax.min;
+    statistics.max = minMax.max;
+    statistics.mean = known ? sums.sum / statistics.count : std::numeric_limits<double>::quiet_NaN();
+    statistics.rms = known ? std::sqrt(sums.squares / statistics.count) : std::numeric_limits<double>::quiet_NaN();
+
+    return statistics;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::applyScatter(int idGraph, size_t generation, std::shared_ptr<const ScatterIndex> scatter)
+{
+    TRACE_SPAN("applyScatter");
+
+    // Graph is deleted or newer cloud is already shown
+    auto found = m_graphs.find(idGraph);
+    if (found == m_graphs.end() || found->second.generation >= generation)
+        return;
+
+    found->second.scatter = std::move(scatter);
+    found->second.generation = generation;
+
+    if (m_taskPool)
+        scheduleRefresh();
+    else
+        refreshScene();
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool OpenGLWidget<type, T>::drawBuffer(int idGraph, const GraphData &data, size_t first, size_t last)
+{
+    if (data.hash == 0)
+        return false;
+
+    // Indices of buffer are counted from start of graph and values are absolute, so far from zero they lose
+    // precision in float, then samples are drawn relative to origin in immediate mode
+    auto minMax = data.pyramid->getMinMax();
+    double extent = std::max(std::abs(static_cast<double>(minMax.min)), std::abs(static_cast<double>(minMax.max)));
+    if (!m_camera.isPrecise(last * m_stepGraph, extent))
+        return false;
+
+    // Vertices are (index, value), so one buffer serves any starting point and step
+    using vertex_t = std::conditional_t<T == TYPE_VISIBLE::DOUBLE, GLdouble, GLfloat>;
+
+    QOpenGLBuffer *buffer{nullptr};
+    auto found = m_graphBuffers.find(idGraph);
+    if (found != m_graphBuffers.end() && found->second == data.hash) {
+        buffer = m_bufferCache->get(data.hash);
+    } else {
+        releaseBuffer(idGraph);
+
+        buffer = m_bufferCache->acquire(data.hash);
+        if (!buffer) {
+            TRACE_SPAN("upload buffer");
+
+            std::vector<vertex_t> vertices(2 * data.graph.size());
+            for (size_t i = 0; i < data.graph.size(); ++i) {
+                vertices[2 * i] = static_cast<vertex_t>(i);
+                vertices[2 * i + 1] = static_cast<vertex_t>(data.graph[i]);
+            }
+
+            int bytes = static_cast<int>(vertices.size() * sizeof(vertex_t));
+            buffer = m_bufferCache->create(data.hash, vertices.data(), bytes);
+            m_hudBytes += bytes;
+        }
+        if (!buffer)
+            return false;
+
+        m_graphBuffers[idGraph] = data.hash;
+    }
+
+    buffer->bind();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, T == TYPE_VISIBLE::DOUBLE ? GL_DOUBLE : GL_FLOAT, 0, nullptr);
+
+    glPushMatrix();
+    glTranslated(data.startPoint - m_camera.origin.first, -m_camera.origin.second, 0);
+    glScaled(m_stepGraph, 1, 1);
+    glDrawArrays(primitive(), static_cast<GLint>(first), static_cast<GLsizei>(last - first));
+    glPopMatrix();
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+    buffer->release();
+
+    m_renderCounters.vertices += last - first;
+
+    return true;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::releaseBuffer(int idGraph)
+{
+    auto found = m_graphBuffers.find(idGraph);
+    if (found == m_graphBuffers.end())
+        return;
+
+    m_bufferCache->release(found->second);
+    m_graphBuffers.erase(found);
+}
+
+template<typename type, TYPE_VISIBLE T>
+QPointF OpenGLWidget<type, T>::coordWDtoGL(QPoint point)
+{
+    return m_camera.toGL(point);
+}
+
+template<typename type, TYPE_VISIBLE T>
+QPoint OpenGLWidget<type, T>::coordGLtoWD(QPointF point)
+{
+    return m_camera.toWD(point);
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::applyCamera()
+{
+    // Projection is folded in view transform, which is computed in double for vertices relative to origin
+    m_camera.updateOrigin();
+
+    std::pair<double, double> translate, scale;
+    m_camera.transform(translate, scale);
+
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+
+    glTranslated(translate.first, translate.second, 0.0);
+    glScaled(scale.first, scale.second, 1.0);
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::resetScene()
+{
+    FrameTiming::ScopedTimer timer{m_frameTiming, FRAME_PHASE::RESET_SCENE};
+    TRACE_SPAN("resetScene");
+
+    m_camera.zoom = {1, 1};
+    m_lastZoomFactor = {1, 1};
+    m_camera.offset = {0, 0};
+    m_lastMousePosWD = {0, 0};
+    m_currMousePosWD = {0, 0};
+    m_lastMousePosGL = {0, 0};
+    m_currMousePosGL = {0, 0};
+
+    if (m_graphs.empty())
+        return;
+
+    bool first{false};
+
+    for (auto &graph : m_graphs) {
+        const auto &data = graph.second;
+        if (data.show == false)
+            continue;
+
+        if (data.source) {
+            // Extents of graph source may be known only after its levels of detail are built
+            typename MinMaxPyramid<type>::Bucket minMax;
+            if (!data.source->getExtentsY(minMax.min, minMax.max))
+                continue;
+
+            double startPoint = data.source->startPoint();
+            double endPoint = startPoint + data.source->size() * data.source->step();
+            if (!first) {
+                m_camera.minMaxX = {startPoint, endPoint};
+                m_camera.minMaxY = {minMax.min, minMax.max};
+                first = true;
+            }
+
+            m_camera.minMaxX.first = std::min(startPoint, m_camera.minMaxX.first);
+            m_camera.minMaxX.second = std::max(endPoint, m_camera.minMaxX.second);
+            m_camera.minMaxY.first = std::min<double>(minMax.min, m_camera.minMaxY.first);
+            m_camera.minMaxY.second = std::max<double>(minMax.max, m_camera.minMaxY.second);
+            continue;
+        }
+
+        if (data.scatter || data.waterfall) {
+            double minX, maxX, minY, maxY;
+            if (data.waterfall) {
+                if (data.waterfall->total() == 0)
+                    continue;
+
+                minX = data.startPoint;
+                maxX = data.startPoint + data.waterfall->width() * m_stepGraph;
+                maxY = data.waterfall->total() * data.waterfall->rowStep();
+                minY = maxY - data.waterfall->shownRows() * data.waterfall->rowStep();
+            } else if (!data.scatter->getExtents(minX, maxX, minY, maxY)) {
+                continue;
+            }
+
+            if (!first) {
+                m_camera.minMaxX = {minX, maxX};
+                m_camera.minMaxY = {minY, maxY};
+                first = true;
+            }
+
+            m_camera.minMaxX.first = std::min(minX, m_camera.minMaxX.first);
+            m_camera.minMaxX.second = std::max(maxX, m_camera.minMaxX.second);
+            m_camera.minMaxY.first = std::min(minY, m_camera.minMaxY.first);
+            m_camera.minMaxY.second = std::max(maxY, m_camera.minMaxY.second);
+            continue;
+        }
+
+        if (data.graph.empty())
+            continue;
+
+        if (!first) {
+            m_camera.minMaxX.first = m_camera.minMaxX.second = data.startPoint;
+            m_camera.minMaxY.first = m_camera.minMaxY.second = data.graph[0];
+            first = true;
+        }
+
+        if (data.startPoint < m_camera.minMaxX.first)
+            m_camera.minMaxX.first = data.startPoint;
+
+        double endPoint = data.x.empty() ? data.startPoint + data.graph.size() * m_stepGraph
+                                         : data.startPoint + data.x.back();
+        if (endPoint > m_camera.minMaxX.second)
+            m_camera.minMaxX.second = endPoint;
+
+        // Extents are taken from levels of detail, they are built with graph values
+        typename MinMaxPyramid<type>::Bucket minMax;
+        if (data.pyramid)
+            minMax = data.pyramid->getMinMax();
+        else
+            minMax = {*std::min_element(data.graph.begin(), data.graph.end()),
+                      *std::max_element(data.graph.begin(), data.graph.end())};
+
+        m_camera.minMaxY.first = std::min<double>(minMax.min, m_camera.minMaxY.first);
+        m_camera.minMaxY.second = std::max<double>(minMax.max, m_camera.minMaxY.second);
+    }
+
+    m_camera.sceneSize.first = m_camera.minMaxX.second - m_camera.minMaxX.first;
+    m_camera.sceneSize.second = m_camera.minMaxY.second - m_camera.minMaxY.first;
+
+    if (m_camera.sceneSize.first == 0)
+        m_camera.sceneSize.first = 1;
+    if (m_camera.sceneSize.second == 0)
+        m_camera.sceneSize.second = 1;
+
+    if (m_staticStepGrid.first <= 0)
+        m_stepGrid.first = m_camera.sceneSize.first / DEFAULT_STEP_GRID;
+    if (m_staticStepGrid.second <= 0)
+        m_stepGrid.second = m_camera.sceneSize.second / DEFAULT_STEP_GRID;
+
+    if (m_init)
+        updateGLBorder();
 }
 
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::updateMouseMove()
 {
     m_selectedSceneEnd = m_currMousePosGL;
-    if (m_selectedSceneEnd.x() > m_saveSelectedBegin.x()) {
+    // Range is measured in both directions, there is no reset by selection
+    if (m_selectedSceneEnd.x() > m_saveSelectedBegin.x() || m_measureMode) {
         m_mouseMoveMode = MOUSE_MOVE_MODE::ZOOM;
         if (m_sceneMode == SCENE_MODE::HORIZONTAL) {
-            m_selectedSceneBegin.setY(coordWDtoGL(QPoint{0, m_WDSize.second}).y());
+            m_selectedSceneBegin.setY(coordWDtoGL(QPoint{0, m_camera.size.second}).y());
             m_selectedSceneEnd.setY(coordWDtoGL(QPoint{0, 1}).y());
         } else if (m_sceneMode == SCENE_MODE::VERTICAL) {
             m_selectedSceneBegin.setX(coordWDtoGL(QPoint{1, 0}).x());
-            m_selectedSceneEnd.setX(coordWDtoGL(QPoint{m_WDSize.first, 0}).x());
+            m_selectedSceneEnd.setX(coordWDtoGL(QPoint{m_camera.size.first, 0}).x());
         } else {
-            if (m_currMousePosWD.x() > m_WDSize.first)
-                m_selectedSceneEnd.setX(coordWDtoGL(QPoint{m_WDSize.first, 0}).x());
-            if (m_currMousePosWD.y() > m_WDSize.second)
-                m_selectedSceneEnd.setY(coordWDtoGL(QPoint{0, m_WDSize.second}).y());
+            if (m_currMousePosWD.x() > m_camera.size.first)
+                m_selectedSceneEnd.setX(coordWDtoGL(QPoint{m_camera.size.first, 0}).x());
+            if (m_currMousePosWD.y() > m_camera.size.second)
+                m_selectedSceneEnd.setY(coordWDtoGL(QPoint{0, m_camera.size.second}).y());
             if (m_currMousePosWD.y() < 0)
                 m_selectedSceneEnd.setY(coordWDtoGL(QPoint{0, 1}).y());
         }
@@ -1237,103 +3513,89 @@ void OpenGLWidget<type, T>::updateBorder()
 {
     QRectF rec;
     rec.setLeft(coordWDtoGL({0, 0}).x());
-    rec.setRight(coordWDtoGL({m_WDSize.first, 0}).x());
-    rec.setBottom(coordWDtoGL({0, m_WDSize.second}).y());
+    rec.setRight(coordWDtoGL({m_camera.size.first, 0}).x());
+    rec.setBottom(coordWDtoGL({0, m_camera.size.second}).y());
     rec.setTop(coordWDtoGL({0, 0}).y());
 
     // X backward shift calculation
-    if (rec.right() >= m_borderMaxGL.x())
-        m_offset.first += (rec.right() - m_borderMaxGL.x()) * m_zoomFactor.first + m_pixelSize.first;
-    else if (rec.left() <= m_borderMinGL.x())
-        m_offset.first += (rec.left() - m_borderMinGL.x()) * m_zoomFactor.first - m_pixelSize.first;
+    if (rec.right() >= m_camera.borderMax.x())
+        m_camera.offset.first += (rec.right() - m_camera.borderMax.x()) * m_camera.zoom.first + m_camera.pixelSize.first;
+    else if (rec.left() <= m_camera.borderMin.x())
+        m_camera.offset.first += (rec.left() - m_camera.borderMin.x()) * m_camera.zoom.first - m_camera.pixelSize.first;
 
     // Y backward shift calculation
-    if (rec.top() >= m_borderMaxGL.y())
-        m_offset.second += (rec.top() - m_borderMaxGL.y()) * m_zoomFactor.second  - m_pixelSize.second;
-    else if (rec.bottom() <= m_borderMinGL.y())
-        m_offset.second += (rec.bottom() - m_borderMinGL.y()) * m_zoomFactor.second + m_pixelSize.second;
+    if (rec.top() >= m_camera.borderMax.y())
+        m_camera.offset.second += (rec.top() - m_camera.borderMax.y()) * m_camera.zoom.second  - m_camera.pixelSize.second;
+    else if (rec.bottom() <= m_camera.borderMin.y())
+        m_camera.offset.second += (rec.bottom() - m_camera.borderMin.y()) * m_camera.zoom.second + m_camera.pixelSize.second;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::fillGrid(std::vector<double> &lines, double base, double step, double min, double max,
+                                     bool divided)
+{
+    lines.clear();
+
+    double coarseStep = divided ? step * ZOOM_FACTOR_GRID : step;
+    if (!(coarseStep > 0) || max <= min || (max - min) / step > GRID_MAX_LINES)
+        return;
+
+    // Coordinates are counted from base in double, so grid stays exact at any zoom
+    double first = std::ceil((min - base) / coarseStep);
+    double last = std::floor((max - base) / coarseStep);
+    for (double i = first; i <= last; ++i)
+        lines.push_back(base + i * coarseStep);
+
+    if (!divided)
+        return;
+
+    for (double i = first - 1; i <= last; ++i) {
+        for (int j = 1; j < ZOOM_FACTOR_GRID; ++j) {
+            double line = base + i * coarseStep + j * step;
+            if (line >= min && line <= max)
+                lines.push_back(line);
+        }
+    }
 }
 
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::updateGrid(bool updateFullGrid)
 {
+    FrameTiming::ScopedTimer timer{m_frameTiming, FRAME_PHASE::UPDATE_GRID};
+    TRACE_SPAN("updateGrid");
+
     QRectF rec;
     rec.setLeft(coordWDtoGL({0, 0}).x());
-    rec.setRight(coordWDtoGL({m_WDSize.first, 0}).x());
-    rec.setBottom(coordWDtoGL({0, m_WDSize.second}).y());
+    rec.setRight(coordWDtoGL({m_camera.size.first, 0}).x());
+    rec.setBottom(coordWDtoGL({0, m_camera.size.second}).y());
     rec.setTop(coordWDtoGL({0, 0}).y());
 
-    m_axes = {coordWDtoGL(QPoint{0, 0}), coordWDtoGL(QPoint{m_WDSize.first, m_WDSize.second})};
-    m_axes.first.setX(m_axes.first.x() + m_sceneSize.first / 1000 / m_zoomFactor.first);
-    m_axes.second.setY(m_axes.second.y() + m_sceneSize.second / 1000 / m_zoomFactor.second);
+    m_axes = {coordWDtoGL(QPoint{0, 0}), coordWDtoGL(QPoint{m_camera.size.first, m_camera.size.second})};
+    m_axes.first.setX(m_axes.first.x() + m_camera.sceneSize.first / 1000 / m_camera.zoom.first);
+    m_axes.second.setY(m_axes.second.y() + m_camera.sceneSize.second / 1000 / m_camera.zoom.second);
 
     m_currMousePosGL = {coordWDtoGL(mapFromGlobal(this->cursor().pos()))};
 
-    if (updateFullGrid) {
-        m_gridVerticalX.clear();
-        m_gridHorizontalY.clear();
-
-        float sizeX = m_MinMaxX.first;
-        while (sizeX < m_borderMaxGL.x() && sizeX > m_borderMinGL.x()) {
-            m_gridVerticalX.push_back(sizeX);
-            sizeX += m_stepGrid.first;
-        }
-        sizeX = m_MinMaxX.first - m_stepGrid.first;
-        while (sizeX < m_borderMaxGL.x() && sizeX > m_borderMinGL.x()) {
-            m_gridVerticalX.push_back(sizeX);
-            sizeX -= m_stepGrid.first;
-        }
-
-        float sizeY = m_MinMaxY.first;
-        while (sizeY < m_borderMaxGL.y() && sizeY > m_borderMinGL.y()) {
-            m_gridHorizontalY.push_back(sizeY);
-            sizeY += m_stepGrid.second;
-        }
-        sizeY = m_MinMaxY.first - m_stepGrid.second;
-        while (sizeY < m_borderMaxGL.y() && sizeY > m_borderMinGL.y()) {
-            m_gridHorizontalY.push_back(sizeY);
-            sizeY -= m_stepGrid.second;
-        }
-    }
-    if (m_lastZoomFactor != m_zoomFactor) {
-        bool work = false;
-        while (m_lastZoomFactor.first * ZOOM_FACTOR_GRID < m_zoomFactor.first) {
-            work = true;
-            m_lastZoomFactor.first *= ZOOM_FACTOR_GRID;
-            size_t size = m_gridVerticalX.size();
-            float k = (float)m_stepGrid.first / m_lastZoomFactor.first;
-            for (size_t i = 0; i < size; ++i) {
-                m_gridVerticalX.push_back(m_gridVerticalX[i] + k);
-            }
-        }
-        if (!work && m_lastZoomFactor.first != START_ZOOM) {
-            while (m_lastZoomFactor.first > m_zoomFactor.first) {
-                m_lastZoomFactor.first /= ZOOM_FACTOR_GRID;
-                size_t size = m_gridVerticalX.size() / ZOOM_FACTOR_GRID;
-                for (size_t i = 0; i < size; ++i) {
-                    m_gridVerticalX.pop_back();
-                }
-            }
-        }
-
-        work = false;
-        while (m_lastZoomFactor.second * ZOOM_FACTOR_GRID < m_zoomFactor.second) {
-            m_lastZoomFactor.second *= ZOOM_FACTOR_GRID;
-            size_t size = m_gridHorizontalY.size();
-            float k = (float)m_stepGrid.second / m_lastZoomFactor.second;
-            for (size_t i = 0; i < size; ++i) {
-                m_gridHorizontalY.push_back(m_gridHorizontalY[i] + k);
-            }
-        }
-        if (!work && m_lastZoomFactor.second != START_ZOOM) {
-            while (m_lastZoomFactor.second > m_zoomFactor.second) {
-                m_lastZoomFactor.second /= ZOOM_FACTOR_GRID;
-                size_t size = m_gridHorizontalY.size() / ZOOM_FACTOR_GRID;
-                for (size_t i = 0; i < size; ++i) {
-                    m_gridHorizontalY.pop_back();
-                }
-            }
-        }
+    // Level of grid follows zoom in powers of ZOOM_FACTOR_GRID
+    std::pair<double, double> lastZoomFactor = m_lastZoomFactor;
+    while (m_lastZoomFactor.first * ZOOM_FACTOR_GRID < m_camera.zoom.first)
+        m_lastZoomFactor.first *= ZOOM_FACTOR_GRID;
+    while (m_lastZoomFactor.first > START_ZOOM && m_lastZoomFactor.first > m_camera.zoom.first)
+        m_lastZoomFactor.first /= ZOOM_FACTOR_GRID;
+    while (m_lastZoomFactor.second * ZOOM_FACTOR_GRID < m_camera.zoom.second)
+        m_lastZoomFactor.second *= ZOOM_FACTOR_GRID;
+    while (m_lastZoomFactor.second > START_ZOOM && m_lastZoomFactor.second > m_camera.zoom.second)
+        m_lastZoomFactor.second /= ZOOM_FACTOR_GRID;
+
+    // Lines cover view and its width on each side, they are placed again when view leaves them
+    if (updateFullGrid || lastZoomFactor != m_lastZoomFactor || !m_gridWindow.contains(rec.normalized())) {
+        m_gridWindow = rec.normalized();
+        m_gridWindow.adjust(-m_gridWindow.width(), -m_gridWindow.height(), m_gridWindow.width(), m_gridWindow.height());
+
+        fillGrid(m_gridVerticalX, m_camera.minMaxX.first, m_stepGrid.first / m_lastZoomFactor.first,
+                 m_gridWindow.left(), m_gridWindow.right(), m_lastZoomFactor.first >= ZOOM_FACTOR_GRID);
+        fillGrid(m_gridHorizontalY, m_camera.minMaxY.first, m_stepGrid.second / m_lastZoomFactor.second,
+                 m_gridWindow.top(), m_gridWindow.bottom(), m_lastZoomFactor.second >= ZOOM_FACTOR_GRID);
     }
 
     m_textVerticalX.clear();
@@ -1341,10 +3603,10 @@ void OpenGLWidget<type, T>::updateGrid(bool updateFullGrid)
     m_valueVerticalX.clear();
     m_valueHorizontalY.clear();
 
-    m_textVerticalX.reserve(m_sceneSize.first / m_stepGrid.first);
-    m_textHorizontalY.reserve(m_sceneSize.second / m_stepGrid.second);
-    m_valueVerticalX.reserve(m_sceneSize.first / m_stepGrid.first);
-    m_valueHorizontalY.reserve(m_sceneSize.second / m_stepGrid.second);
+    m_textVerticalX.reserve(m_camera.sceneSize.first / m_stepGrid.first);
+    m_textHorizontalY.reserve(m_camera.sceneSize.second / m_stepGrid.second);
+    m_valueVerticalX.reserve(m_camera.sceneSize.first / m_stepGrid.first);
+    m_valueHorizontalY.reserve(m_camera.sceneSize.second / m_stepGrid.second);
 
     for (size_t i = 0; i < m_gridVerticalX.size(); i++)
         if (m_gridVerticalX[i] > m_axes.first.x() && m_gridVerticalX[i] < m_axes.second.x()) {
@@ -1362,12 +3624,13 @@ void OpenGLWidget<type, T>::updateGrid(bool updateFullGrid)
     std::sort(m_textVerticalX.begin(), m_textVerticalX.end());
     std::sort(m_textHorizontalY.begin(), m_textHorizontalY.end());
     std::sort(m_valueVerticalX.begin(), m_valueVerticalX.end());
-    std::sort(m_valueHorizontalY.begin(), m_valueHorizontalY.end(), std::greater<float>());
+    std::sort(m_valueHorizontalY.begin(), m_valueHorizontalY.end(), std::greater<double>());
 
-    m_textVerticalX.push_back(coordGLtoWD({m_currMousePosGL.x(), 0}).x());
-    m_textHorizontalY.push_back(coordGLtoWD({0, m_currMousePosGL.y()}).y());
-    m_valueVerticalX.push_back(m_currMousePosGL.x());
-    m_valueHorizontalY.push_back(m_currMousePosGL.y());
+    updateReadout();
+    m_textVerticalX.push_back(coordGLtoWD({m_cursorGL.x(), 0}).x());
+    m_textHorizontalY.push_back(coordGLtoWD({0, m_cursorGL.y()}).y());
+    m_valueVerticalX.push_back(m_cursorGL.x());
+    m_valueHorizontalY.push_back(m_cursorGL.y());
 
     m_signal->triggerSignalTextValues(m_id);
 }
@@ -1375,18 +3638,71 @@ void OpenGLWidget<type, T>::updateGrid(bool updateFullGrid)
 template<typename type, TYPE_VISIBLE T>
 void OpenGLWidget<type, T>::updateGLBorder()
 {
-    // Возможная ошибка при захвате контекста
-    if (false) {
-        makeCurrent();
-        resizeGL(width(), height());
-        doneCurrent();
-    } else {
-        resize(width() - 1, height());
-        resize(width() + 1, height());
+    if (isDeferred()) {
+        m_borderPending = true;
+        return;
     }
 
+    // Projection is applied at draw time, so widget isn't resized to refresh it
+    m_camera.update();
+
     updateGrid(true);
     update();
 }
 
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::refreshScene()
+{
+    m_pickValid = false;
+    if (isDeferred()) {
+        m_resetPending = true;
+        return;
+    }
+
+    if (m_updateSceneAuto)
+        resetScene();
+    update();
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::scheduleRefresh()
+{
+    if (m_refreshScheduled)
+        return;
+
+    m_refreshScheduled = true;
+    QMetaObject::invokeMethod(this, [this]() {
+        m_refreshScheduled = false;
+        refreshScene();
+    }, Qt::QueuedConnection);
+}
+
+template<typename type, TYPE_VISIBLE T>
+bool OpenGLWidget<type, T>::isDeferred()
+{
+    return m_suspended || m_updateDepth > 0;
+}
+
+template<typename type, TYPE_VISIBLE T>
+void OpenGLWidget<type, T>::flushPending()
+{
+    if (isDeferred())
+        return;
+
+    TRACE_SPAN("flushPending");
+
+    for (auto &values : m_pendingValues)
+        buildGraph(values.first, std::move(values.second));
+    m_pendingValues.clear();
+
+    if (m_resetPending && m_updateSceneAuto)
+        resetScene();
+    else if (m_borderPending && m_init)
+        updateGLBorder();
+    m_resetPending = false;
+    m_borderPending = false;
+
+    update();
+}
+
 #endif // OPENGL_WIDGET_H
@@ -0,0 +1,154 @@
+#ifndef PICK_BUFFER_H
+#define PICK_BUFFER_H
+
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QRgb>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#define PICK_RADIUS 3 ///< Half size of neighbourhood read around point, pixels
+#define PICK_MAX_ID 0xFFFFFE ///< Maximum id kept in buffer, ids are stored in 24 bits of color
+
+///
+/// \brief The PickBuffer class - offscreen buffer of ids of graphs. Graphs are drawn there with their ids encoded in
+/// color, without blending and smoothing, so each pixel keeps id of topmost graph. Query reads only small
+/// neighbourhood of point, so its cost doesn't depend on number of graphs
+///
+class PickBuffer : protected QOpenGLFunctions
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    PickBuffer() = default;
+    ~PickBuffer() = default;
+
+    PickBuffer(const PickBuffer &) = delete;
+    PickBuffer &operator=(const PickBuffer &) = delete;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief begin - bind cleared buffer of ids of size of viewport, context must be current
+    /// \return - false if framebuffer isn't supported
+    ///
+    bool begin()
+    {
+        if (!m_initialized) {
+            initializeOpenGLFunctions();
+            m_initialized = true;
+            m_supported = QOpenGLFramebufferObject::hasOpenGLFramebufferObjects();
+        }
+        if (!m_supported)
+            return false;
+
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        QSize size{std::max(viewport[2], 1), std::max(viewport[3], 1)};
+        if (!m_fbo || m_fbo->size() != size)
+            m_fbo = std::make_unique<QOpenGLFramebufferObject>(size);
+        if (!m_fbo->isValid() || !m_fbo->bind()) {
+            m_fbo.reset();
+            m_supported = false;
+            return false;
+        }
+
+        // Mixed colors would be other ids
+        glDisable(GL_BLEND);
+        glDisable(GL_DITHER);
+        glDisable(GL_LINE_SMOOTH);
+        glDisable(GL_POINT_SMOOTH);
+        glClearColor(0, 0, 0, 0);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        return true;
+    }
+
+    ///
+    /// \brief end - bind framebuffer of widget again
+    /// \param target - framebuffer of widget
+    /// \param back - background color, clear color is restored to it
+    ///
+    void end(GLuint target, QRgb back)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+        glClearColor(qRed(back) / 255.0f, qGreen(back) / 255.0f, qBlue(back) / 255.0f, 1.0f);
+        glEnable(GL_DITHER);
+    }
+
+    ///
+    /// \brief setId - set id of next drawn graph
+    /// \param id - id from 0 to PICK_MAX_ID
+    ///
+    static void setId(int id)
+    {
+        // 0 is background
+        unsigned int code = static_cast<unsigned int>(std::clamp(id, 0, PICK_MAX_ID)) + 1;
+        glColor4ub(code & 0xFF, (code >> 8) & 0xFF, (code >> 16) & 0xFF, 255);
+    }
+
+    ///
+    /// \brief pick - find id nearest to point in neighbourhood, context must be current
+    /// \param x - X of point in pixels of buffer, from left
+    /// \param y - Y of point in pixels of buffer, from top
+    /// \param radius - half size of neighbourhood
+    /// \param target - framebuffer bound after reading
+    /// \return - id, -1 if there is no id in neighbourhood
+    ///
+    int pick(int x, int y, int radius, GLuint target)
+    {
+        if (!m_fbo)
+            return -1;
+
+        int height = m_fbo->height();
+        y = height - 1 - y;
+        int left = std::max(0, x - radius), right = std::min(m_fbo->width() - 1, x + radius);
+        int bottom = std::max(0, y - radius), top = std::min(height - 1, y + radius);
+        if (left > right || bottom > top)
+            return -1;
+
+        int width = right - left + 1;
+        m_pixels.resize(static_cast<size_t>(width) * (top - bottom + 1) * 4);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_fbo->handle());
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(left, bottom, width, top - bottom + 1, GL_RGBA, GL_UNSIGNED_BYTE, m_pixels.data());
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+
+        int result{-1}, nearest{};
+        for (int j = bottom; j <= top; ++j) {
+            for (int i = left; i <= right; ++i) {
+                const GLubyte *pixel = m_pixels.data() + (static_cast<size_t>(j - bottom) * width + (i - left)) * 4;
+                unsigned int code = pixel[0] | (pixel[1] << 8) | (pixel[2] << 16);
+                int distance = (i - x) * (i - x) + (j - y) * (j - y);
+                if (code && (result == -1 || distance < nearest)) {
+                    result = static_cast<int>(code) - 1;
+                    nearest = distance;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    ///
+    /// \brief destroy - release GPU resources, context must be current
+    ///
+    void destroy()
+    {
+        m_fbo.reset();
+    }
+
+private:
+
+    // --- Fields ---
+
+    std::unique_ptr<QOpenGLFramebufferObject>      m_fbo; ///< Buffer of ids
+    std::vector<GLubyte>                        m_pixels; ///< Pixels of last read neighbourhood
+    bool                              m_initialized{false}; ///< Whether functions are resolved
+    bool                                m_supported{false}; ///< Whether framebuffer is supported
+};
+
+#endif // PICK_BUFFER_H
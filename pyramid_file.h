@@ -0,0 +1,551 @@
+#ifndef PYRAMID_FILE_H
+#define PYRAMID_FILE_H
+
+#include "mapped_graph_source.h"
+
+#define PYRAMID_FILE_MAGIC 0x50443247 ///< "G2DP", first bytes of multi-resolution graph file
+#define PYRAMID_FILE_VERSION 1 ///< Version of multi-resolution graph file
+#define PYRAMID_FILE_BASE_BLOCK 1024 ///< Default number of samples in bucket of finest stored level
+#define PYRAMID_FILE_CHUNK_SAMPLES (1 << 20) ///< Default number of samples in one chunk
+#define PYRAMID_FILE_INSTANT_BUCKETS 4096 ///< Maximum number of buckets of level loaded when file is opened
+
+///
+/// \brief The PyramidFileHeader struct - header of multi-resolution graph file. File is
+/// [header][samples][extents of each chunk][table of levels][buckets of each level]. While file is written,
+/// extents of complete chunks follow samples and header is rewritten after each chunk, so unfinished file has
+/// readable samples and coarse level of chunks
+///
+struct PyramidFileHeader {
+    quint32               magic{PYRAMID_FILE_MAGIC}; ///< PYRAMID_FILE_MAGIC
+    quint32           version{PYRAMID_FILE_VERSION}; ///< Version of format
+    quint32                           sampleType{0}; ///< SAMPLE_TYPE of samples
+    quint32     headerSize{sizeof(PyramidFileHeader)}; ///< Offset of samples from beginning of file
+    double                            startPoint{0}; ///< Starting point of graph
+    double                                  step{1}; ///< Distance between each value on graph
+    quint64                                count{0}; ///< Number of samples
+    double                                 minY{0}; ///< Minimum value of graph
+    double                                 maxY{0}; ///< Maximum value of graph
+    quint64                            baseBlock{0}; ///< Number of samples in bucket of level 0
+    quint64                         chunkSamples{0}; ///< Number of samples in chunk
+    quint64                           chunkCount{0}; ///< Number of chunks in table of extents
+    quint64                     chunkTableOffset{0}; ///< Offset of table of extents, 0 while samples overwrite it
+    quint64                           levelCount{0}; ///< Number of levels in table of levels
+    quint64                     levelTableOffset{0}; ///< Offset of table of levels, 0 if file is unfinished
+};
+
+///
+/// \brief The PyramidFileExtents struct - minimum and maximum of chunk or bucket
+///
+struct PyramidFileExtents {
+    double min; ///< Minimum value
+    double max; ///< Maximum value
+};
+
+///
+/// \brief The PyramidFileLevel struct - record of table of levels
+///
+struct PyramidFileLevel {
+    quint64                 offset; ///< Offset of buckets of level
+    quint64            bucketCount; ///< Number of complete buckets
+    quint64           partialCount; ///< Number of samples after complete buckets
+    PyramidFileExtents     partial; ///< Extents of samples after complete buckets
+};
+
+///
+/// \brief The PyramidFileWriter class - write multi-resolution graph file incrementally, e.g. during acquisition
+///
+template<typename type>
+class PyramidFileWriter
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    PyramidFileWriter() = default;
+    ~PyramidFileWriter();
+
+    PyramidFileWriter(const PyramidFileWriter &) = delete;
+    PyramidFileWriter &operator=(const PyramidFileWriter &) = delete;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief open - create file
+    /// \param path - path of file
+    /// \param startPoint - starting point of graph
+    /// \param step - distance between each value on graph
+    /// \param baseBlock - number of samples in bucket of level 0
+    /// \param chunkSamples - number of samples in chunk
+    /// \return - true is all good, false is mistake
+    ///
+    bool open(const QString &path, double startPoint, double step, size_t baseBlock = PYRAMID_FILE_BASE_BLOCK,
+              size_t chunkSamples = PYRAMID_FILE_CHUNK_SAMPLES);
+
+    ///
+    /// \brief append - write samples to end of graph, levels and extents are updated incrementally
+    /// \param values - samples
+    /// \param count - number of samples
+    /// \return - true is all good, false is mistake
+    ///
+    bool append(const type *values, size_t count);
+
+    ///
+    /// \brief finish - write extents of chunks and levels, after it samples can't be added
+    /// \return - true is all good, false is mistake
+    ///
+    bool finish();
+
+private:
+
+    // --- Helper methods ---
+
+    ///
+    /// \brief writeHeader - rewrite header at beginning of file
+    /// \return - true is all good, false is mistake
+    ///
+    bool writeHeader();
+
+    ///
+    /// \brief writeChunks - write extents of chunks after samples and set their place in header
+    /// \return - true is all good, false is mistake
+    ///
+    bool writeChunks();
+
+    ///
+    /// \brief toExtents - convert bucket in record of file
+    /// \param bucket - bucket of levels
+    /// \return - record of file
+    ///
+    static PyramidFileExtents toExtents(const typename MinMaxPyramid<type>::Bucket &bucket);
+
+private:
+
+    // --- Fields ---
+
+    QFile                                     m_file; ///< Written file
+    PyramidFileHeader                       m_header; ///< Header of file
+    MinMaxPyramid<type>                    m_pyramid; ///< Levels of detail of written samples
+    std::vector<PyramidFileExtents>         m_chunks; ///< Extents of complete chunks
+    typename MinMaxPyramid<type>::Bucket     m_chunk; ///< Extents of current chunk
+    size_t                             m_chunkFill{0}; ///< Number of samples in current chunk
+    bool                              m_finished{true}; ///< Whether file is finished or not opened
+};
+
+///
+/// \brief The PyramidFileSource class - graph backed by multi-resolution graph file. Opening reads only
+/// header and coarse level, so scene is fitted and first frame is drawn instantly, finer levels are loaded
+/// in background while they fit in quarter of memory budget
+///
+template<typename type>
+class PyramidFileSource : public GraphSource<type>
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    PyramidFileSource() = default;
+    ~PyramidFileSource() override;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief open - open file, load coarse level and start background loading of finer levels
+    /// \param path - path of file
+    /// \return - true is all good, false is mistake
+    ///
+    bool open(const QString &path);
+
+    bool read(size_t first, size_t count, std::vector<type> &values) override;
+
+    // --- Setters ---
+
+    ///
+    /// \brief setMemoryBudget - set budget of resident memory, must be called before open
+    /// \param bytes - budget in bytes
+    ///
+    void setMemoryBudget(size_t bytes);
+
+    // --- Getters ---
+
+    size_t size() const override;
+    double startPoint() const override;
+    double step() const override;
+    bool getExtentsY(type &min, type &max) const override;
+
+private:
+
+    // --- Helper methods ---
+
+    ///
+    /// \brief loadChunks - read extents of complete chunks of unfinished file, they're its only level
+    /// \param file - opened file
+    /// \return - true is all good, false is mistake
+    ///
+    bool loadChunks(QFile &file);
+
+    ///
+    /// \brief loadLevel - read level from file and build coarser levels from it
+    /// \param file - opened file
+    /// \param level - index of level
+    /// \return - levels of detail, nullptr if reading failed
+    ///
+    std::shared_ptr<const MinMaxPyramid<type>> loadLevel(QFile &file, size_t level);
+
+    ///
+    /// \brief loadFinerLevels - background loading of finer levels
+    /// \param path - path of file
+    /// \param level - index of loaded level
+    ///
+    void loadFinerLevels(QString path, size_t level);
+
+private:
+
+    // --- Fields ---
+
+    MappedFileWindows                          m_windows; ///< Samples read on demand
+    PyramidFileHeader                           m_header; ///< Header of file
+    std::vector<PyramidFileLevel>               m_levels; ///< Table of levels
+    size_t                 m_budget{MAPPED_MEMORY_BUDGET}; ///< Budget of resident memory in bytes
+
+    std::thread                                 m_loader; ///< Background loading of finer levels
+    std::atomic<bool>                       m_stop{false}; ///< Stop background loading
+};
+
+template<typename type>
+PyramidFileWriter<type>::~PyramidFileWriter()
+{
+    finish();
+}
+
+template<typename type>
+bool PyramidFileWriter<type>::open(const QString &path, double startPoint, double step, size_t baseBlock,
+                                   size_t chunkSamples)
+{
+    finish();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate))
+        return false;
+
+    m_header = PyramidFileHeader{};
+    m_header.sampleType = static_cast<quint32>(sampleTypeOf<type>());
+    m_header.startPoint = startPoint;
+    m_header.step = step;
+    m_header.baseBlock = baseBlock;
+    m_header.chunkSamples = chunkSamples;
+
+    m_pyramid = MinMaxPyramid<type>{baseBlock};
+    m_chunks.clear();
+    m_chunkFill = 0;
+    m_finished = false;
+
+    return writeHeader();
+}
+
+template<typename type>
+bool PyramidFileWriter<type>::append(const type *values, size_t count)
+{
+    if (m_finished)
+        return false;
+
+    // Extents of chunks are overwritten by new samples, so readers don't see them until they're written again
+    if (m_header.chunkTableOffset) {
+        m_header.chunkTableOffset = 0;
+        if (!writeHeader())
+            return false;
+    }
+
+    if (!m_file.seek(m_header.headerSize + m_header.count * sizeof(type))
+            || m_file.write(reinterpret_cast<const char *>(values), count * sizeof(type)) != qint64(count * sizeof(type)))
+        return false;
+
+    m_pyramid.append(values, count);
+    m_header.count += count;
+
+    bool chunkDone{false};
+    size_t i{};
+    while (i < count) {
+        size_t take = std::min(count - i, m_header.chunkSamples - m_chunkFill);
+        auto bucket = MinMaxPyramid<type>::computeBucket(values + i, take);
+        m_chunk = m_chunkFill ? MinMaxPyramid<type>::combine(m_chunk, bucket) : bucket;
+        m_chunkFill += take;
+        i += take;
+
+        if (m_chunkFill == m_header.chunkSamples) {
+            m_chunks.push_back(toExtents(m_chunk));
+            m_chunkFill = 0;
+            chunkDone = true;
+        }
+    }
+
+    // Unfinished file stays readable up to last complete chunk
+    if (chunkDone) {
+        auto minMax = m_pyramid.getMinMax();
+        m_header.minY = minMax.min;
+        m_header.maxY = minMax.max;
+        return writeChunks() && writeHeader();
+    }
+
+    return true;
+}
+
+template<typename type>
+bool PyramidFileWriter<type>::finish()
+{
+    if (m_finished)
+        return true;
+    m_finished = true;
+
+    if (m_chunkFill)
+        m_chunks.push_back(toExtents(m_chunk));
+
+    if (m_header.count) {
+        auto minMax = m_pyramid.getMinMax();
+        m_header.minY = minMax.min;
+        m_header.maxY = minMax.max;
+    }
+
+    // Extents of chunks
+    if (!writeChunks())
+        return false;
+    quint64 offset = m_header.chunkTableOffset + m_chunks.size() * sizeof(PyramidFileExtents);
+    qint64 bytes{};
+
+    // Table of levels, buckets follow it
+    std::vector<PyramidFileLevel> levels(m_pyramid.levelCount());
+    m_header.levelCount = levels.size();
+    m_header.levelTableOffset = offset;
+    offset += levels.size() * sizeof(PyramidFileLevel);
+
+    std::vector<PyramidFileExtents> buckets;
+    for (size_t l = 0; l < levels.size(); ++l) {
+        const auto &level = m_pyramid.level(l);
+        size_t covered = level.size() * m_pyramid.blockSize(l);
+
+        levels[l].offset = offset;
+        levels[l].bucketCount = level.size();
+        levels[l].partialCount = m_header.count - covered;
+        levels[l].partial = PyramidFileExtents{0, 0};
+
+        bool first{true};
+        typename MinMaxPyramid<type>::Bucket partial{};
+        m_pyramid.forEachBucket(l, covered, m_header.count, [&](size_t, size_t, const auto & bucket) {
+            partial = first ? bucket : MinMaxPyramid<type>::combine(partial, bucket);
+            first = false;
+        });
+        if (!first)
+            levels[l].partial = toExtents(partial);
+
+        buckets.resize(level.size());
+        for (size_t i = 0; i < level.size(); ++i)
+            buckets[i] = toExtents(level[i]);
+
+        bytes = buckets.size() * sizeof(PyramidFileExtents);
+        if (!m_file.seek(offset) || m_file.write(reinterpret_cast<const char *>(buckets.data()), bytes) != bytes)
+            return false;
+        offset += bytes;
+    }
+
+    bytes = levels.size() * sizeof(PyramidFileLevel);
+    if (!m_file.seek(m_header.levelTableOffset)
+            || m_file.write(reinterpret_cast<const char *>(levels.data()), bytes) != bytes)
+        return false;
+
+    bool result = writeHeader();
+    m_file.close();
+
+    return result;
+}
+
+template<typename type>
+bool PyramidFileWriter<type>::writeHeader()
+{
+    return m_file.seek(0)
+           && m_file.write(reinterpret_cast<const char *>(&m_header), sizeof(m_header)) == sizeof(m_header)
+           && m_file.flush();
+}
+
+template<typename type>
+bool PyramidFileWriter<type>::writeChunks()
+{
+    quint64 offset = m_header.headerSize + m_header.count * sizeof(type);
+    qint64 bytes = m_chunks.size() * sizeof(PyramidFileExtents);
+    if (!m_file.seek(offset) || m_file.write(reinterpret_cast<const char *>(m_chunks.data()), bytes) != bytes)
+        return false;
+
+    m_header.chunkCount = m_chunks.size();
+    m_header.chunkTableOffset = offset;
+
+    return true;
+}
+
+template<typename type>
+PyramidFileExtents PyramidFileWriter<type>::toExtents(const typename MinMaxPyramid<type>::Bucket &bucket)
+{
+    return PyramidFileExtents{static_cast<double>(bucket.min), static_cast<double>(bucket.max)};
+}
+
+template<typename type>
+PyramidFileSource<type>::~PyramidFileSource()
+{
+    m_stop = true;
+    if (m_loader.joinable())
+        m_loader.join();
+}
+
+template<typename type>
+bool PyramidFileSource<type>::open(const QString &path)
+{
+    QFile file{path};
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    if (file.read(reinterpret_cast<char *>(&m_header), sizeof(m_header)) != sizeof(m_header)
+            || m_header.magic != PYRAMID_FILE_MAGIC || m_header.version != PYRAMID_FILE_VERSION
+            || m_header.headerSize < sizeof(m_header) || m_header.baseBlock == 0)
+        return false;
+
+    m_windows.setMemoryBudget(m_budget / 2);
+    if (!m_windows.open(path)
+            || !m_windows.setLayout(m_header.headerSize, static_cast<SAMPLE_TYPE>(m_header.sampleType), m_header.count))
+        return false;
+
+    if (m_header.levelTableOffset == 0 || m_header.levelCount == 0)
+        return loadChunks(file);
+
+    m_levels.resize(m_header.levelCount);
+    qint64 bytes = m_levels.size() * sizeof(PyramidFileLevel);
+    if (!file.seek(m_header.levelTableOffset) || file.read(reinterpret_cast<char *>(m_levels.data()), bytes) != bytes)
+        return false;
+
+    // Coarse level for first frame
+    size_t level = m_levels.size() - 1;
+    while (level > 0 && m_levels[level - 1].bucketCount <= PYRAMID_FILE_INSTANT_BUCKETS)
+        --level;
+
+    auto pyramid = loadLevel(file, level);
+    if (!pyramid)
+        return false;
+    this->publishPyramid(std::move(pyramid));
+
+    if (level > 0)
+        m_loader = std::thread(&PyramidFileSource<type>::loadFinerLevels, this, path, level);
+
+    return true;
+}
+
+template<typename type>
+bool PyramidFileSource<type>::read(size_t first, size_t count, std::vector<type> &values)
+{
+    return m_windows.read(first, count, values);
+}
+
+template<typename type>
+void PyramidFileSource<type>::setMemoryBudget(size_t bytes)
+{
+    m_budget = bytes;
+}
+
+template<typename type>
+size_t PyramidFileSource<type>::size() const
+{
+    return m_windows.count();
+}
+
+template<typename type>
+double PyramidFileSource<type>::startPoint() const
+{
+    return m_header.startPoint;
+}
+
+template<typename type>
+double PyramidFileSource<type>::step() const
+{
+    return m_header.step;
+}
+
+template<typename type>
+bool PyramidFileSource<type>::getExtentsY(type &min, type &max) const
+{
+    if (m_header.count == 0)
+        return false;
+
+    min = static_cast<type>(m_header.minY);
+    max = static_cast<type>(m_header.maxY);
+
+    return true;
+}
+
+template<typename type>
+bool PyramidFileSource<type>::loadChunks(QFile &file)
+{
+    using Bucket = typename MinMaxPyramid<type>::Bucket;
+
+    // Before first chunk is complete file has only samples, they're fewer than in chunk
+    if (m_header.chunkTableOffset == 0 || m_header.chunkCount == 0)
+        return true;
+    if (m_header.chunkSamples == 0 || m_header.chunkCount > m_header.count / m_header.chunkSamples)
+        return false;
+
+    std::vector<PyramidFileExtents> extents(m_header.chunkCount);
+    qint64 bytes = extents.size() * sizeof(PyramidFileExtents);
+    if (!file.seek(m_header.chunkTableOffset) || file.read(reinterpret_cast<char *>(extents.data()), bytes) != bytes)
+        return false;
+
+    std::vector<Bucket> buckets(extents.size());
+    for (size_t i = 0; i < extents.size(); ++i)
+        buckets[i] = Bucket{static_cast<type>(extents[i].min), static_cast<type>(extents[i].max)};
+
+    // Samples after complete chunks are drawn raw
+    auto pyramid = std::make_shared<MinMaxPyramid<type>>(m_header.chunkSamples);
+    pyramid->setBaseLevel(std::move(buckets), Bucket{}, 0);
+    this->publishPyramid(std::move(pyramid));
+
+    return true;
+}
+
+template<typename type>
+std::shared_ptr<const MinMaxPyramid<type>> PyramidFileSource<type>::loadLevel(QFile &file, size_t level)
+{
+    using Bucket = typename MinMaxPyramid<type>::Bucket;
+
+    const PyramidFileLevel &record = m_levels[level];
+    std::vector<PyramidFileExtents> extents(record.bucketCount);
+    qint64 bytes = extents.size() * sizeof(PyramidFileExtents);
+    if (!file.seek(record.offset) || file.read(reinterpret_cast<char *>(extents.data()), bytes) != bytes)
+        return nullptr;
+
+    std::vector<Bucket> buckets(extents.size());
+    for (size_t i = 0; i < extents.size(); ++i)
+        buckets[i] = Bucket{static_cast<type>(extents[i].min), static_cast<type>(extents[i].max)};
+
+    auto pyramid = std::make_shared<MinMaxPyramid<type>>(m_header.baseBlock << level);
+    pyramid->setBaseLevel(std::move(buckets),
+                          Bucket{static_cast<type>(record.partial.min), static_cast<type>(record.partial.max)},
+                          record.partialCount);
+
+    return pyramid;
+}
+
+template<typename type>
+void PyramidFileSource<type>::loadFinerLevels(QString path, size_t level)
+{
+    QFile file{path};
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    using Bucket = typename MinMaxPyramid<type>::Bucket;
+
+    while (level > 0 && !m_stop) {
+        --level;
+        if (m_levels[level].bucketCount * 2 * sizeof(Bucket) > m_budget / 4)
+            return;
+
+        auto pyramid = loadLevel(file, level);
+        if (!pyramid || m_stop)
+            return;
+        this->publishPyramid(std::move(pyramid));
+    }
+}
+
+#endif // PYRAMID_FILE_H
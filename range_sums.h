@@ -0,0 +1,127 @@
+#ifndef RANGE_SUMS_H
+#define RANGE_SUMS_H
+
+#include "lod_pyramid.h"
+
+#include <vector>
+#include <algorithm>
+
+///
+/// \brief The RangeSums class - prefix sums of samples and of their squares by blocks of LOD_BASE_BLOCK samples,
+/// built together with levels of detail. Sums of any range are taken from two prefixes, and only its edges
+/// inside blocks are scanned in raw samples, so cost doesn't depend on size of range
+///
+template<typename type>
+class RangeSums
+{
+public:
+
+    // --- Helper structs ---
+
+    ///
+    /// \brief The Sums struct - sums of samples of block or range
+    ///
+    struct Sums {
+        double     sum{0}; ///< Sum of samples
+        double squares{0}; ///< Sum of squares of samples
+    };
+
+    // --- Constructors/destructors ---
+
+    RangeSums() = default;
+    ~RangeSums() = default;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief computeBlock - count sums of samples
+    /// \param values - samples
+    /// \param count - number of samples
+    /// \return - sums of samples
+    ///
+    static Sums computeBlock(const type *values, size_t count)
+    {
+        Sums sums;
+        for (size_t i = 0; i < count; ++i) {
+            double value = values[i];
+            sums.sum += value;
+            sums.squares += value * value;
+        }
+
+        return sums;
+    }
+
+    ///
+    /// \brief setBlocks - replace prefixes with ones of blocks counted elsewhere (e.g. in parallel by chunks)
+    /// \param blocks - sums of each complete block, they become prefixes in place
+    ///
+    void setBlocks(std::vector<Sums> &&blocks)
+    {
+        m_prefixes = std::move(blocks);
+        Sums total;
+        for (Sums &block : m_prefixes) {
+            Sums next{total.sum + block.sum, total.squares + block.squares};
+            block = total;
+            total = next;
+        }
+        m_prefixes.push_back(total);
+    }
+
+    ///
+    /// \brief rangeSums - sums of samples [first, last)
+    /// \param values - raw samples, prefixes are built from them
+    /// \param first - first sample
+    /// \param last - sample after last
+    /// \return - sums of samples
+    ///
+    Sums rangeSums(const type *values, size_t first, size_t last) const
+    {
+        size_t blocks = m_prefixes.empty() ? 0 : m_prefixes.size() - 1;
+        size_t head = std::min(last, (first + LOD_BASE_BLOCK - 1) / LOD_BASE_BLOCK * LOD_BASE_BLOCK);
+        size_t tail = std::max(head, std::min(last / LOD_BASE_BLOCK, blocks) * LOD_BASE_BLOCK);
+        if (first >= last)
+            return Sums{};
+
+        // Edges are summed directly, middle blocks by difference of prefixes
+        Sums result = computeBlock(values + first, head - first);
+        if (tail > head) {
+            const Sums &begin = m_prefixes[head / LOD_BASE_BLOCK];
+            const Sums &end = m_prefixes[tail / LOD_BASE_BLOCK];
+            result.sum += end.sum - begin.sum;
+            result.squares += end.squares - begin.squares;
+        }
+        Sums rest = computeBlock(values + tail, last - tail);
+        result.sum += rest.sum;
+        result.squares += rest.squares;
+
+        return result;
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief samples - number of samples covered by prefixes
+    /// \return - number of samples
+    ///
+    size_t samples() const
+    {
+        return m_prefixes.empty() ? 0 : (m_prefixes.size() - 1) * LOD_BASE_BLOCK;
+    }
+
+    ///
+    /// \brief memorySize - bytes taken by prefixes
+    /// \return - bytes
+    ///
+    size_t memorySize() const
+    {
+        return m_prefixes.capacity() * sizeof(Sums);
+    }
+
+private:
+
+    // --- Fields ---
+
+    std::vector<Sums>                  m_prefixes; ///< Sums of blocks before each block, last is sums of all
+};
+
+#endif // RANGE_SUMS_H
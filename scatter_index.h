@@ -0,0 +1,207 @@
+#ifndef SCATTER_INDEX_H
+#define SCATTER_INDEX_H
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#define SCATTER_CELL_POINTS 256 ///< Average number of points in cell of index
+#define SCATTER_MAX_CELLS 1024 ///< Maximum number of cells along one axis
+
+///
+/// \brief The ScatterIndex class - uniform grid over cloud of points. Points are stored cell by cell in random
+/// order, so any beginning of cell is even sample of it. Cells outside view are skipped and dense cells are drawn
+/// only by their beginning
+///
+class ScatterIndex
+{
+public:
+
+    // --- Helper structs ---
+
+    ///
+    /// \brief The Point struct - point of cloud
+    ///
+    struct Point {
+        double x; ///< Coordinate X
+        double y; ///< Coordinate Y
+    };
+
+    // --- Constructors/destructors ---
+
+    ScatterIndex() = default;
+    ~ScatterIndex() = default;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief build - sort points by cells, points which aren't finite are dropped
+    /// \param x - coordinates X
+    /// \param y - coordinates Y, same number as X
+    ///
+    void build(const std::vector<double> &x, const std::vector<double> &y)
+    {
+        size_t count = std::min(x.size(), y.size());
+
+        m_points.clear();
+        m_points.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            if (std::isfinite(x[i]) && std::isfinite(y[i]))
+                m_points.push_back(Point{x[i], y[i]});
+        }
+        m_offsets.assign(2, 0);
+        m_cellsX = m_cellsY = 1;
+        if (m_points.empty())
+            return;
+
+        m_minX = m_maxX = m_points[0].x;
+        m_minY = m_maxY = m_points[0].y;
+        for (const auto &point : m_points) {
+            m_minX = std::min(m_minX, point.x);
+            m_maxX = std::max(m_maxX, point.x);
+            m_minY = std::min(m_minY, point.y);
+            m_maxY = std::max(m_maxY, point.y);
+        }
+
+        size_t cells = static_cast<size_t>(std::sqrt(static_cast<double>(m_points.size()) / SCATTER_CELL_POINTS));
+        m_cellsX = m_cellsY = std::clamp<size_t>(cells, 1, SCATTER_MAX_CELLS);
+        m_cellWidth = m_maxX > m_minX ? (m_maxX - m_minX) / m_cellsX : 1;
+        m_cellHeight = m_maxY > m_minY ? (m_maxY - m_minY) / m_cellsY : 1;
+
+        // Counting sort by cells
+        std::vector<size_t> cellOfPoint(m_points.size());
+        m_offsets.assign(m_cellsX * m_cellsY + 1, 0);
+        for (size_t i = 0; i < m_points.size(); ++i) {
+            cellOfPoint[i] = cellX(m_points[i].x) + cellY(m_points[i].y) * m_cellsX;
+            ++m_offsets[cellOfPoint[i] + 1];
+        }
+        for (size_t i = 1; i < m_offsets.size(); ++i)
+            m_offsets[i] += m_offsets[i - 1];
+
+        std::vector<Point> sorted(m_points.size());
+        std::vector<size_t> position(m_offsets.begin(), m_offsets.end() - 1);
+        for (size_t i = 0; i < m_points.size(); ++i)
+            sorted[position[cellOfPoint[i]]++] = m_points[i];
+        m_points = std::move(sorted);
+
+        // Fixed seed, so same cloud is always subsampled in same way and doesn't flicker
+        std::minstd_rand random{1};
+        for (size_t cell = 0; cell + 1 < m_offsets.size(); ++cell)
+            std::shuffle(m_points.begin() + m_offsets[cell], m_points.begin() + m_offsets[cell + 1], random);
+    }
+
+    ///
+    /// \brief forEachCell - walk cells which intersect rectangle
+    /// \param minX - left side of rectangle
+    /// \param maxX - right side of rectangle
+    /// \param minY - bottom side of rectangle
+    /// \param maxY - top side of rectangle
+    /// \param func - called with (points of cell, number of points)
+    ///
+    template<typename Func>
+    void forEachCell(double minX, double maxX, double minY, double maxY, Func func) const
+    {
+        if (m_points.empty() || maxX < m_minX || minX > m_maxX || maxY < m_minY || minY > m_maxY)
+            return;
+
+        size_t firstX = cellX(minX), lastX = cellX(maxX);
+        size_t firstY = cellY(minY), lastY = cellY(maxY);
+        for (size_t cy = firstY; cy <= lastY; ++cy) {
+            for (size_t cx = firstX; cx <= lastX; ++cx) {
+                size_t cell = cx + cy * m_cellsX;
+                if (m_offsets[cell + 1] > m_offsets[cell])
+                    func(m_points.data() + m_offsets[cell], m_offsets[cell + 1] - m_offsets[cell]);
+            }
+        }
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief size - number of points
+    /// \return - number of points
+    ///
+    size_t size() const
+    {
+        return m_points.size();
+    }
+
+    ///
+    /// \brief getExtents - get minimum and maximum coordinates of points
+    /// \param minX - minimum X
+    /// \param maxX - maximum X
+    /// \param minY - minimum Y
+    /// \param maxY - maximum Y
+    /// \return - false if cloud is empty
+    ///
+    bool getExtents(double &minX, double &maxX, double &minY, double &maxY) const
+    {
+        if (m_points.empty())
+            return false;
+
+        minX = m_minX;
+        maxX = m_maxX;
+        minY = m_minY;
+        maxY = m_maxY;
+
+        return true;
+    }
+
+    ///
+    /// \brief cellSize - size of cell in scene measure
+    /// \return - width and height of cell
+    ///
+    std::pair<double, double> cellSize() const
+    {
+        return {m_cellWidth, m_cellHeight};
+    }
+
+    ///
+    /// \brief memorySize - bytes taken by index
+    /// \return - bytes
+    ///
+    size_t memorySize() const
+    {
+        return m_points.capacity() * sizeof(Point) + m_offsets.capacity() * sizeof(size_t);
+    }
+
+private:
+
+    // --- Helper methods ---
+
+    ///
+    /// \brief cellX - column of cell with coordinate, clamped to grid
+    /// \param x - coordinate X
+    /// \return - column
+    ///
+    size_t cellX(double x) const
+    {
+        return static_cast<size_t>(std::clamp((x - m_minX) / m_cellWidth, 0.0, static_cast<double>(m_cellsX - 1)));
+    }
+
+    ///
+    /// \brief cellY - row of cell with coordinate, clamped to grid
+    /// \param y - coordinate Y
+    /// \return - row
+    ///
+    size_t cellY(double y) const
+    {
+        return static_cast<size_t>(std::clamp((y - m_minY) / m_cellHeight, 0.0, static_cast<double>(m_cellsY - 1)));
+    }
+
+    // --- Fields ---
+
+    std::vector<Point>     m_points; ///< Points ordered by cells, random order inside cell
+    std::vector<size_t>   m_offsets; ///< Index of first point of each cell, last is number of points
+    size_t              m_cellsX{1}; ///< Number of columns of grid
+    size_t              m_cellsY{1}; ///< Number of rows of grid
+    double            m_cellWidth{1}; ///< Width of cell
+    double           m_cellHeight{1}; ///< Height of cell
+    double                 m_minX{0}; ///< Minimum X of points
+    double                 m_maxX{0}; ///< Maximum X of points
+    double                 m_minY{0}; ///< Minimum Y of points
+    double                 m_maxY{0}; ///< Maximum Y of points
+};
+
+#endif // SCATTER_INDEX_H
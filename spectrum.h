@@ -0,0 +1,150 @@
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#define SPECTRUM_MIN_SIZE 8 ///< Minimum number of samples of transform
+#define SPECTRUM_FLOOR_DB -200 ///< Level of bins without power, dB
+
+///
+/// \brief The SpectrumPlan class - windowed FFT of fixed size. Window, twiddles and work buffers are allocated once,
+/// so transform doesn't allocate. Real and imaginary parts are kept in separate arrays and twiddles of each stage are
+/// contiguous, so inner loops of butterflies are vectorized by compiler
+///
+class SpectrumPlan
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    ///
+    /// \brief SpectrumPlan - prepare transform
+    /// \param size - number of samples, rounded up to power of 2
+    ///
+    explicit SpectrumPlan(size_t size)
+    {
+        m_size = SPECTRUM_MIN_SIZE;
+        while (m_size < size)
+            m_size <<= 1;
+
+        const double pi = std::acos(-1.0);
+
+        // Hann window, spectrum is normalized by its sum, so tone of amplitude A has level of A
+        m_window.resize(m_size);
+        double sum{};
+        for (size_t i = 0; i < m_size; ++i) {
+            m_window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2 * pi * i / m_size));
+            sum += m_window[i];
+        }
+        m_scale = static_cast<float>(2 / sum);
+
+        m_reverse.resize(m_size);
+        size_t bits{};
+        while ((size_t{1} << bits) < m_size)
+            ++bits;
+        for (size_t i = 0; i < m_size; ++i) {
+            size_t reversed{};
+            for (size_t bit = 0; bit < bits; ++bit)
+                reversed |= ((i >> bit) & 1) << (bits - 1 - bit);
+            m_reverse[i] = reversed;
+        }
+
+        // Twiddles of stage with half length h start at h - 1
+        m_twiddleRe.resize(m_size);
+        m_twiddleIm.resize(m_size);
+        for (size_t half = 1; half < m_size; half <<= 1) {
+            for (size_t j = 0; j < half; ++j) {
+                m_twiddleRe[half - 1 + j] = static_cast<float>(std::cos(pi * j / half));
+                m_twiddleIm[half - 1 + j] = static_cast<float>(-std::sin(pi * j / half));
+            }
+        }
+
+        m_re.resize(m_size);
+        m_im.resize(m_size);
+    }
+    ~SpectrumPlan() = default;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief compute - level of each frequency bin
+    /// \param input - samples
+    /// \param count - number of samples, missing samples are zeros, extra samples are ignored
+    /// \param output - levels of bins in dB, bins() values
+    ///
+    template<typename type>
+    void compute(const type *input, size_t count, float *output)
+    {
+        count = std::min(count, m_size);
+        for (size_t i = 0; i < m_size; ++i) {
+            m_re[m_reverse[i]] = i < count ? static_cast<float>(input[i]) * m_window[i] : 0.0f;
+            m_im[i] = 0;
+        }
+
+        float *re = m_re.data();
+        float *im = m_im.data();
+        for (size_t half = 1; half < m_size; half <<= 1) {
+            const float *twiddleRe = m_twiddleRe.data() + half - 1;
+            const float *twiddleIm = m_twiddleIm.data() + half - 1;
+            for (size_t start = 0; start < m_size; start += 2 * half) {
+                float *aRe = re + start, *aIm = im + start;
+                float *bRe = aRe + half, *bIm = aIm + half;
+                for (size_t j = 0; j < half; ++j) {
+                    float tRe = bRe[j] * twiddleRe[j] - bIm[j] * twiddleIm[j];
+                    float tIm = bRe[j] * twiddleIm[j] + bIm[j] * twiddleRe[j];
+                    bRe[j] = aRe[j] - tRe;
+                    bIm[j] = aIm[j] - tIm;
+                    aRe[j] += tRe;
+                    aIm[j] += tIm;
+                }
+            }
+        }
+
+        // Zero and last bins have no negative frequency pair
+        const float floor = std::pow(10.0f, SPECTRUM_FLOOR_DB / 20.0f);
+        for (size_t i = 0; i < bins(); ++i) {
+            float magnitude = std::sqrt(re[i] * re[i] + im[i] * im[i]) * m_scale;
+            if (i == 0 || i == m_size / 2)
+                magnitude /= 2;
+            output[i] = 20 * std::log10(std::max(magnitude, floor));
+        }
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief size - number of samples of transform
+    /// \return - number of samples
+    ///
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    ///
+    /// \brief bins - number of frequency bins, from zero to half of sample rate
+    /// \return - number of bins
+    ///
+    size_t bins() const
+    {
+        return m_size / 2 + 1;
+    }
+
+private:
+
+    // --- Fields ---
+
+    size_t                        m_size; ///< Number of samples of transform
+    float                    m_scale{1}; ///< Normalization of magnitudes by window
+    std::vector<float>          m_window; ///< Coefficients of window
+    std::vector<size_t>        m_reverse; ///< Bit-reversed index of each sample
+    std::vector<float>       m_twiddleRe; ///< Real parts of twiddles of all stages
+    std::vector<float>       m_twiddleIm; ///< Imaginary parts of twiddles of all stages
+    std::vector<float>              m_re; ///< Real parts of work buffer
+    std::vector<float>              m_im; ///< Imaginary parts of work buffer
+};
+
+#endif // SPECTRUM_H
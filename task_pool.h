@@ -0,0 +1,247 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+///
+/// \brief The TaskGroup class - count unfinished tasks of owner, so owner can wait for them before it's destroyed
+///
+class TaskGroup
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    TaskGroup() = default;
+    ~TaskGroup() = default;
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief add - register submitted task
+    ///
+    void add()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        ++m_count;
+    }
+
+    ///
+    /// \brief done - register finished task
+    ///
+    void done()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (--m_count == 0)
+            m_finished.notify_all();
+    }
+
+    ///
+    /// \brief wait - wait until all registered tasks are finished
+    ///
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_finished.wait(lock, [this]() {
+            return m_count == 0;
+        });
+    }
+
+private:
+
+    // --- Fields ---
+
+    std::mutex                     m_mutex; ///< Guard of counter
+    std::condition_variable     m_finished; ///< Notified when all tasks are finished
+    size_t                      m_count{0}; ///< Number of unfinished tasks
+};
+
+///
+/// \brief The TaskPool class - work-stealing pool of threads. Each thread has own queue, tasks submitted from
+/// thread of pool go to its queue and are taken from back, idle threads steal from front of other queues.
+/// Remaining tasks are finished when pool is destroyed
+///
+class TaskPool
+{
+public:
+
+    // --- Helper aliases ---
+
+    using Task = std::function<void()>;
+
+    // --- Constructors/destructors ---
+
+    ///
+    /// \brief TaskPool - start threads
+    /// \param threads - number of threads, 0 is number of cores except one for GUI thread
+    ///
+    explicit TaskPool(size_t threads = 0)
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency()) - (std::thread::hardware_concurrency() > 1);
+
+        for (size_t i = 0; i < threads; ++i)
+            m_queues.push_back(std::make_unique<Queue>());
+        for (size_t i = 0; i < threads; ++i)
+            m_threads.emplace_back(&TaskPool::run, this, i);
+    }
+    ~TaskPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_sleepMutex};
+            m_stop = true;
+        }
+        m_wake.notify_all();
+
+        for (auto &thread : m_threads)
+            thread.join();
+    }
+
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief submit - add task to pool
+    /// \param task - executed function
+    /// \param group - group in which task is registered, may be nullptr
+    ///
+    void submit(Task task, TaskGroup *group = nullptr)
+    {
+        if (group)
+            group->add();
+
+        size_t index = t_pool == this ? t_index : m_next++ % m_queues.size();
+        {
+            std::lock_guard<std::mutex> lock{m_queues[index]->mutex};
+            m_queues[index]->tasks.push_back(Item{std::move(task), group});
+        }
+        {
+            std::lock_guard<std::mutex> lock{m_sleepMutex};
+            ++m_pending;
+        }
+        m_wake.notify_one();
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief threadCount - number of threads of pool
+    /// \return - number of threads
+    ///
+    size_t threadCount() const
+    {
+        return m_threads.size();
+    }
+
+private:
+
+    // --- Helper structs ---
+
+    ///
+    /// \brief The Item struct - queued task
+    ///
+    struct Item {
+        Task          task; ///< Executed function
+        TaskGroup   *group; ///< Group of task, may be nullptr
+    };
+
+    ///
+    /// \brief The Queue struct - queue of one thread
+    ///
+    struct Queue {
+        std::mutex         mutex; ///< Guard of queue
+        std::deque<Item>   tasks; ///< Queued tasks
+    };
+
+    // --- Helper methods ---
+
+    ///
+    /// \brief run - loop of thread of pool
+    /// \param index - index of thread
+    ///
+    void run(size_t index)
+    {
+        t_pool = this;
+        t_index = index;
+
+        Item item;
+        while (true) {
+            if (take(index, item)) {
+                item.task();
+                if (item.group)
+                    item.group->done();
+                item = Item{};
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock{m_sleepMutex};
+            m_wake.wait(lock, [this]() {
+                return m_pending > 0 || m_stop;
+            });
+            if (m_pending == 0 && m_stop)
+                return;
+        }
+    }
+
+    ///
+    /// \brief take - take task from own queue or steal it from other queue
+    /// \param index - index of thread
+    /// \param item - where task is written
+    /// \return - true if task is taken
+    ///
+    bool take(size_t index, Item &item)
+    {
+        for (size_t i = 0; i < m_queues.size(); ++i) {
+            Queue &queue = *m_queues[(index + i) % m_queues.size()];
+            std::lock_guard<std::mutex> lock{queue.mutex};
+            if (queue.tasks.empty())
+                continue;
+
+            // Own queue is taken from back, which is hot in cache, other queues from front
+            if (i == 0) {
+                item = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                item = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+
+            std::lock_guard<std::mutex> sleepLock{m_sleepMutex};
+            --m_pending;
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+
+    // --- Fields ---
+
+    std::vector<std::unique_ptr<Queue>>    m_queues; ///< Queue of each thread
+    std::vector<std::thread>              m_threads; ///< Threads of pool
+    std::atomic<size_t>                    m_next{0}; ///< Round-robin queue for tasks submitted from outside
+
+    std::mutex                          m_sleepMutex; ///< Guard of sleeping
+    std::condition_variable                   m_wake; ///< Notified when task is submitted or pool is stopped
+    size_t                              m_pending{0}; ///< Number of queued tasks
+    bool                                m_stop{false}; ///< Stop threads when queues are empty
+
+    static inline thread_local TaskPool     *t_pool{nullptr}; ///< Pool of current thread
+    static inline thread_local size_t        t_index{0}; ///< Index of current thread in its pool
+};
+
+#endif // TASK_POOL_H
@@ -0,0 +1,357 @@
+#include "main_widget.h"
+
+#include <QColor>
+#include <QDir>
+#include <QSignalSpy>
+#include <QtTest>
+
+#include <cmath>
+
+#define GOLDEN_WIDTH 640 ///< Width of rendered scenes, pixels
+#define GOLDEN_HEIGHT 400 ///< Height of rendered scenes, pixels
+#define GOLDEN_CHANNEL_TOLERANCE 16 ///< Difference of channel of pixel that isn't counted as mismatch
+#define GOLDEN_PIXEL_TOLERANCE 0.005 ///< Share of mismatched pixels at which scene still matches reference
+#define GOLDEN_MANY_GRAPHS 64 ///< Number of graphs in scene of many graphs
+#define GOLDEN_DEEP_ZOOM 1e4 ///< Zoom along X of scene of deep zoom
+
+///
+/// \brief The OpenGLWidgetProbe class - waits for background work of OpenGLWidget
+///
+template<typename type, TYPE_VISIBLE T>
+class OpenGLWidgetProbe
+{
+public:
+
+    // --- Main methods ---
+
+    ///
+    /// \brief settle - wait for background builds of widget and apply their results
+    /// \param widget - rendered widget
+    ///
+    static void settle(OpenGLWidget<type, T> &widget)
+    {
+        // Each pass may submit next one (extents, levels of detail)
+        for (int i = 0; i < 4; ++i) {
+            widget.m_taskGroup.wait();
+            QCoreApplication::processEvents();
+        }
+    }
+
+    ///
+    /// \brief zoom - zoom scene along X around center of widget as wheel does
+    /// \param widget - rendered widget
+    /// \param factor - zoom factor
+    ///
+    static void zoom(OpenGLWidget<type, T> &widget, double factor)
+    {
+        QPoint center{widget.width() / 2, widget.height() / 2};
+        QPointF before = widget.coordWDtoGL(center);
+        widget.m_camera.zoom.first *= factor;
+        QPointF after = widget.coordWDtoGL(center);
+        widget.m_camera.offset.first += (after.x() - before.x()) * widget.m_camera.zoom.first;
+
+        widget.updateBorder();
+        widget.updateGrid(true);
+        widget.update();
+    }
+};
+
+///
+/// \brief The MainWidgetProbe class - access to widgets of tabs of MainWidget
+///
+template<typename type, TYPE_VISIBLE T>
+class MainWidgetProbe
+{
+public:
+
+    // --- Main methods ---
+
+    ///
+    /// \brief openGLWidget - get widget of tab
+    /// \param widget - rendered widget
+    /// \param idTab - id of tab
+    /// \return - widget of tab
+    ///
+    static OpenGLWidget<type, T> &openGLWidget(MainWidget<type, T> &widget, int idTab)
+    {
+        return *widget.m_tabs[idTab].OGLWidget;
+    }
+};
+
+///
+/// \brief makeGraph - sine with harmonic, same on every run
+/// \param samples - number of samples
+/// \param amplitude - amplitude of sine
+/// \return - graph values
+///
+template<typename type>
+static std::vector<type> makeGraph(size_t samples, double amplitude)
+{
+    std::vector<type> graph(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        double phase = 2 * 3.14159265358979323846 * i / samples;
+        graph[i] = static_cast<type>(amplitude * (std::sin(3 * phase) + 0.3 * std::sin(40 * phase)));
+    }
+
+    return graph;
+}
+
+///
+/// \brief The GoldenTest class - renders canonical scenes offscreen and compares them with stored images
+///
+class GoldenTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+
+    void lineDouble();
+    void columnInt();
+    void rectangleShort();
+    void scatterFloat();
+    void envelopeDouble();
+    void manyGraphsDouble();
+    void deepZoomDouble();
+    void frameBudgetExceeded();
+    void frameBudgetDisabled();
+
+private:
+
+    ///
+    /// \brief checkScene - render graphs in widget of fixed size with full quality, compare image with reference and
+    /// check that frames of scene fit in budget
+    /// \param name - name of scene
+    /// \param graphs - values of each graph
+    /// \param mode - mode of graphs
+    /// \param budget - budget of p95 of CPU and GPU time of frame, milliseconds
+    /// \param zoom - zoom along X around center of widget
+    ///
+    template<typename type, TYPE_VISIBLE T>
+    void checkScene(const QString &name, std::vector<std::vector<type>> graphs,
+                    typename OpenGLWidget<type, T>::GRAPH_MODE mode, double budget, double zoom = 1);
+
+    ///
+    /// \brief compareGolden - compare image with reference of scene, reference is written if WIDGET_UPDATE_GOLDEN
+    /// is set; actual image is kept in working directory if reference is missing, difference too on mismatch
+    /// \param name - name of scene
+    /// \param image - rendered image
+    ///
+    void compareGolden(const QString &name, const QImage &image);
+
+    ///
+    /// \brief budgetSignals - render enough frames to check frame budget and count signals of exceeding it
+    /// \param ms - budget in milliseconds
+    /// \return - number of signals, -1 if OpenGL isn't available
+    ///
+    int budgetSignals(double ms);
+};
+
+template<typename type, TYPE_VISIBLE T>
+void GoldenTest::checkScene(const QString &name, std::vector<std::vector<type>> graphs,
+                            typename OpenGLWidget<type, T>::GRAPH_MODE mode, double budget, double zoom)
+{
+    MainWidget<type, T> widget;
+    int idTab = widget.addTab("Golden");
+    OpenGLWidget<type, T> &openGLWidget = MainWidgetProbe<type, T>::openGLWidget(widget, idTab);
+
+    // Nothing in image depends on time, cursor or fonts of legend and axes
+    openGLWidget.setFixedSize(GOLDEN_WIDTH, GOLDEN_HEIGHT);
+    widget.setRefineBudget(0);
+    widget.setQualityTarget(0);
+    widget.setGridCursorVisible(false);
+    widget.setGraphMode(mode);
+    for (size_t i = 0; i < graphs.size(); ++i) {
+        QRgb color = graphs.size() == 1 ? qRgb(0, 0, 255)
+                                        : QColor::fromHsv(static_cast<int>(360 * i / graphs.size()), 255, 200).rgb();
+        widget.addGraph(idTab, graphs[i], color);
+    }
+    widget.show();
+
+    OpenGLWidgetProbe<type, T>::settle(openGLWidget);
+    if (zoom != 1) {
+        OpenGLWidgetProbe<type, T>::zoom(openGLWidget, zoom);
+        OpenGLWidgetProbe<type, T>::settle(openGLWidget);
+    }
+
+    QImage image = openGLWidget.grabFramebuffer();
+    if (image.isNull())
+        QSKIP("OpenGL context isn't available");
+
+    compareGolden(name, image.convertToFormat(QImage::Format_RGB32));
+    if (QTest::currentTestFailed())
+        return;
+
+    // Frames of same scene, first one initialized GL and uploaded buffers
+    openGLWidget.getFrameTiming().clear();
+    widget.setFrameBudget(idTab, budget);
+    QSignalSpy spy{widget.getSignal(), &WidgetSignals::frameBudgetExceeded};
+    for (int i = 0; i < FRAME_STATISTICS_PERIOD; ++i)
+        openGLWidget.grabFramebuffer();
+
+    FrameStatistics statistics = widget.getFrameStatistics(idTab);
+    QVERIFY2(statistics[FRAME_PHASE::PAINT].p95 <= budget,
+             qPrintable(QString("p95 of paintGL %1 ms is over budget %2 ms")
+                        .arg(statistics[FRAME_PHASE::PAINT].p95).arg(budget)));
+    QVERIFY2(statistics[FRAME_PHASE::DRAW_GPU].p95 <= budget,
+             qPrintable(QString("p95 of GPU time %1 ms is over budget %2 ms")
+                        .arg(statistics[FRAME_PHASE::DRAW_GPU].p95).arg(budget)));
+    QCOMPARE(spy.count(), 0);
+}
+
+void GoldenTest::compareGolden(const QString &name, const QImage &image)
+{
+    QString path = QDir{GOLDEN_DIR}.filePath(name + ".png");
+    if (qEnvironmentVariableIsSet("WIDGET_UPDATE_GOLDEN")) {
+        QDir{}.mkpath(GOLDEN_DIR);
+        QVERIFY2(image.save(path), qPrintable("Can't write " + path));
+        return;
+    }
+
+    QImage reference{path};
+    if (reference.isNull()) {
+        image.save(name + ".actual.png");
+        QFAIL(qPrintable("No reference " + path + ", run with WIDGET_UPDATE_GOLDEN=1 to store it"));
+    }
+    reference = reference.convertToFormat(QImage::Format_RGB32);
+    QCOMPARE(image.size(), reference.size());
+
+    QImage difference{image.size(), QImage::Format_RGB32};
+    size_t mismatched{0};
+    for (int y = 0; y < image.height(); ++y) {
+        const QRgb *actualLine = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        const QRgb *referenceLine = reinterpret_cast<const QRgb *>(reference.constScanLine(y));
+        QRgb *differenceLine = reinterpret_cast<QRgb *>(difference.scanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            int red = std::abs(qRed(actualLine[x]) - qRed(referenceLine[x]));
+            int green = std::abs(qGreen(actualLine[x]) - qGreen(referenceLine[x]));
+            int blue = std::abs(qBlue(actualLine[x]) - qBlue(referenceLine[x]));
+            bool mismatch = std::max({red, green, blue}) > GOLDEN_CHANNEL_TOLERANCE;
+            mismatched += mismatch;
+            differenceLine[x] = mismatch ? qRgb(255, 0, 0) : qRgb(red, green, blue);
+        }
+    }
+
+    double share = static_cast<double>(mismatched) / (static_cast<size_t>(image.width()) * image.height());
+    if (share > GOLDEN_PIXEL_TOLERANCE) {
+        image.save(name + ".actual.png");
+        difference.save(name + ".diff.png");
+    }
+    QVERIFY2(share <= GOLDEN_PIXEL_TOLERANCE,
+             qPrintable(QString("%1% of pixels differ from %2").arg(share * 100, 0, 'f', 3).arg(path)));
+}
+
+int GoldenTest::budgetSignals(double ms)
+{
+    using OGLW = OpenGLWidget<double, TYPE_VISIBLE::DOUBLE>;
+
+    MainWidget<double, TYPE_VISIBLE::DOUBLE> widget;
+    int idTab = widget.addTab("Budget");
+    OGLW &openGLWidget = MainWidgetProbe<double, TYPE_VISIBLE::DOUBLE>::openGLWidget(widget, idTab);
+    openGLWidget.setFixedSize(GOLDEN_WIDTH, GOLDEN_HEIGHT);
+
+    std::vector<double> graph = makeGraph<double>(100000, 1);
+    widget.addGraph(idTab, graph);
+    widget.setFrameBudget(idTab, ms);
+    widget.show();
+
+    OpenGLWidgetProbe<double, TYPE_VISIBLE::DOUBLE>::settle(openGLWidget);
+    if (openGLWidget.grabFramebuffer().isNull())
+        return -1;
+
+    QSignalSpy spy{widget.getSignal(), &WidgetSignals::frameBudgetExceeded};
+    for (int i = 0; i < FRAME_STATISTICS_PERIOD; ++i)
+        openGLWidget.grabFramebuffer();
+
+    for (const QList<QVariant> &arguments : spy)
+        if (arguments.at(0).toInt() != idTab)
+            return -2;
+
+    return spy.count();
+}
+
+// Budgets are p95 of frame of Mesa in software with margin for slow runners of CI
+
+void GoldenTest::lineDouble()
+{
+    using OGLW = OpenGLWidget<double, TYPE_VISIBLE::DOUBLE>;
+    checkScene<double, TYPE_VISIBLE::DOUBLE>("line_double", {makeGraph<double>(10000, 1.5)},
+                                             OGLW::GRAPH_MODE::LINE, 50);
+}
+
+void GoldenTest::columnInt()
+{
+    using OGLW = OpenGLWidget<int, TYPE_VISIBLE::INT>;
+    checkScene<int, TYPE_VISIBLE::INT>("column_int", {makeGraph<int>(64, 1000)}, OGLW::GRAPH_MODE::COLUMN, 50);
+}
+
+void GoldenTest::rectangleShort()
+{
+    using OGLW = OpenGLWidget<short, TYPE_VISIBLE::SHORT>;
+    checkScene<short, TYPE_VISIBLE::SHORT>("rectangle_short", {makeGraph<short>(48, 100)},
+                                           OGLW::GRAPH_MODE::RECTANGLE, 50);
+}
+
+void GoldenTest::scatterFloat()
+{
+    using OGLW = OpenGLWidget<float, TYPE_VISIBLE::FLOAT>;
+    checkScene<float, TYPE_VISIBLE::FLOAT>("scatter_float", {makeGraph<float>(500, 10)},
+                                           OGLW::GRAPH_MODE::SCATTER, 50);
+}
+
+void GoldenTest::envelopeDouble()
+{
+    // Many samples per pixel, graph is drawn from levels of detail
+    using OGLW = OpenGLWidget<double, TYPE_VISIBLE::DOUBLE>;
+    checkScene<double, TYPE_VISIBLE::DOUBLE>("envelope_double", {makeGraph<double>(4000000, 1)},
+                                             OGLW::GRAPH_MODE::LINE, 100);
+}
+
+void GoldenTest::manyGraphsDouble()
+{
+    // Each graph has own color and amplitude, they're drawn over each other
+    using OGLW = OpenGLWidget<double, TYPE_VISIBLE::DOUBLE>;
+    std::vector<std::vector<double>> graphs;
+    for (int i = 0; i < GOLDEN_MANY_GRAPHS; ++i)
+        graphs.push_back(makeGraph<double>(10000, 1 + 0.1 * i));
+    checkScene<double, TYPE_VISIBLE::DOUBLE>("many_graphs_double", std::move(graphs), OGLW::GRAPH_MODE::LINE, 200);
+}
+
+void GoldenTest::deepZoomDouble()
+{
+    // About hundred samples of long graph are in view, their vertices are drawn relative to origin of view
+    using OGLW = OpenGLWidget<double, TYPE_VISIBLE::DOUBLE>;
+    checkScene<double, TYPE_VISIBLE::DOUBLE>("deep_zoom_double", {makeGraph<double>(1000000, 1)},
+                                             OGLW::GRAPH_MODE::LINE, 50, GOLDEN_DEEP_ZOOM);
+}
+
+void GoldenTest::frameBudgetExceeded()
+{
+    // Any frame takes longer than nanosecond
+    int count = budgetSignals(1e-6);
+    if (count == -1)
+        QSKIP("OpenGL context isn't available");
+    QVERIFY2(count != -2, "frameBudgetExceeded is emitted with id of other tab");
+    QVERIFY(count > 0);
+}
+
+void GoldenTest::frameBudgetDisabled()
+{
+    int count = budgetSignals(0);
+    if (count == -1)
+        QSKIP("OpenGL context isn't available");
+    QCOMPARE(count, 0);
+}
+
+int main(int argc, char *argv[])
+{
+    // Scenes are rendered offscreen unless platform is chosen explicitly
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication application{argc, argv};
+    GoldenTest test;
+
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "golden_test.moc"
@@ -0,0 +1,231 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <QFile>
+#include <QTextStream>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define TRACE_RING_SIZE 16384 ///< Number of last spans kept for each thread
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+///
+/// \brief TRACE_SPAN - record span from this line to end of scope, name must be string literal
+///
+#define TRACE_SPAN(name) TraceRecorder::ScopedSpan TRACE_CONCAT(traceSpan, __LINE__){name}
+
+///
+/// \brief The TraceRecorder class - record timestamped spans in per-thread ring buffers and dump them
+/// in Chrome trace format (chrome://tracing, Perfetto)
+///
+class TraceRecorder
+{
+public:
+
+    // --- Helper classes ---
+
+    ///
+    /// \brief The ScopedSpan class - record span of scope, does nothing if tracing is disabled
+    ///
+    class ScopedSpan
+    {
+    public:
+
+        // --- Constructors/destructors ---
+
+        explicit ScopedSpan(const char *name)
+            : m_name{name}, m_begin{-1}
+        {
+            if (TraceRecorder::instance().isEnabled())
+                m_begin = TraceRecorder::instance().now();
+        }
+        ~ScopedSpan()
+        {
+            if (m_begin >= 0)
+                TraceRecorder::instance().addSpan(m_name, m_begin, TraceRecorder::instance().now());
+        }
+
+        ScopedSpan(const ScopedSpan &) = delete;
+        ScopedSpan &operator=(const ScopedSpan &) = delete;
+
+    private:
+
+        // --- Fields ---
+
+        const char *m_name; ///< Name of span
+        qint64     m_begin; ///< Start of span in nanoseconds, -1 if span isn't recorded
+    };
+
+    // --- Main methods ---
+
+    ///
+    /// \brief instance - get recorder shared by all threads
+    /// \return - recorder
+    ///
+    static TraceRecorder &instance()
+    {
+        static TraceRecorder recorder;
+        return recorder;
+    }
+
+    ///
+    /// \brief addSpan - add span to ring buffer of calling thread
+    /// \param name - name of span, must live until dump (string literal)
+    /// \param begin - start of span in nanoseconds
+    /// \param end - end of span in nanoseconds
+    ///
+    void addSpan(const char *name, qint64 begin, qint64 end)
+    {
+        ThreadBuffer &buffer = threadBuffer();
+        size_t count = buffer.count.load(std::memory_order_relaxed);
+        buffer.events[count % TRACE_RING_SIZE] = TraceEvent{name, begin, end - begin};
+        buffer.count.store(count + 1, std::memory_order_release);
+    }
+
+    ///
+    /// \brief clear - drop all recorded spans
+    ///
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        for (auto &buffer : m_buffers)
+            buffer->count.store(0, std::memory_order_release);
+    }
+
+    ///
+    /// \brief dumpChromeTrace - write recorded spans in Chrome trace JSON, best called while threads are quiet,
+    /// otherwise oldest spans of busy thread can be overwritten during dump
+    /// \param path - path of file
+    /// \return - true is all good, false is mistake
+    ///
+    bool dumpChromeTrace(const QString &path)
+    {
+        QFile file{path};
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+            return false;
+
+        QTextStream stream{&file};
+        stream << "{\"traceEvents\":[";
+
+        bool first{true};
+        std::lock_guard<std::mutex> lock{m_mutex};
+        for (const auto &buffer : m_buffers) {
+            size_t count = buffer->count.load(std::memory_order_acquire);
+            size_t begin = count > TRACE_RING_SIZE ? count - TRACE_RING_SIZE : 0;
+
+            for (size_t i = begin; i < count; ++i) {
+                const TraceEvent &event = buffer->events[i % TRACE_RING_SIZE];
+                if (!first)
+                    stream << ",";
+                first = false;
+
+                stream << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                       << ",\"ts\":" << QString::number(event.begin / 1000.0, 'f', 3)
+                       << ",\"dur\":" << QString::number(event.duration / 1000.0, 'f', 3) << "}";
+            }
+        }
+
+        stream << "]}\n";
+        stream.flush();
+
+        return stream.status() == QTextStream::Ok;
+    }
+
+    // --- Setters ---
+
+    ///
+    /// \brief setEnabled - whether to record spans
+    /// \param enabled - whether to record spans
+    ///
+    void setEnabled(bool enabled)
+    {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief isEnabled - whether spans are recorded
+    /// \return - whether spans are recorded
+    ///
+    bool isEnabled() const
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    ///
+    /// \brief now - get current time of trace clock
+    /// \return - nanoseconds since creation of recorder
+    ///
+    qint64 now() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private:
+
+    // --- Helper structs ---
+
+    ///
+    /// \brief The TraceEvent struct - one recorded span
+    ///
+    struct TraceEvent {
+        const char  *name; ///< Name of span
+        qint64      begin; ///< Start in nanoseconds
+        qint64   duration; ///< Duration in nanoseconds
+    };
+
+    ///
+    /// \brief The ThreadBuffer struct - ring of spans written only by its thread
+    ///
+    struct ThreadBuffer {
+        std::array<TraceEvent, TRACE_RING_SIZE> events; ///< Ring of spans
+        std::atomic<size_t>               count{0}; ///< Total spans written
+        int                            threadId{0}; ///< Id of thread in trace
+    };
+
+    // --- Constructors/destructors ---
+
+    TraceRecorder()
+        : m_enabled{false}, m_start{std::chrono::steady_clock::now()}
+    {}
+    ~TraceRecorder() = default;
+
+    // --- Helper methods ---
+
+    ///
+    /// \brief threadBuffer - get ring buffer of calling thread, created on first span of thread
+    /// \return - ring buffer of calling thread
+    ///
+    ThreadBuffer &threadBuffer()
+    {
+        static thread_local ThreadBuffer *buffer = nullptr;
+        if (buffer)
+            return *buffer;
+
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffer = m_buffers.back().get();
+        buffer->threadId = static_cast<int>(m_buffers.size());
+
+        return *buffer;
+    }
+
+private:
+
+    // --- Fields ---
+
+    std::atomic<bool>                                m_enabled; ///< Whether spans are recorded
+    std::chrono::steady_clock::time_point              m_start; ///< Zero of trace clock
+    std::mutex                                         m_mutex; ///< Guard of list of buffers
+    std::vector<std::unique_ptr<ThreadBuffer>>       m_buffers; ///< Buffers of all threads that recorded spans
+};
+
+#endif // TRACE_RECORDER_H
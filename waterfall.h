@@ -0,0 +1,324 @@
+#ifndef WATERFALL_H
+#define WATERFALL_H
+
+#include "colormap.h"
+
+#include <QOpenGLBuffer>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#ifndef GL_R32F
+#define GL_R32F 0x822E
+#endif
+
+#ifndef GL_RED
+#define GL_RED 0x1903
+#endif
+
+#define WATERFALL_MAX_ROWS 4096 ///< Maximum number of rows kept in history, it's height of texture
+
+///
+/// \brief The Waterfall class - rows of values over time, e.g. spectra. History is kept in ring texture: each row
+/// is uploaded once through pixel buffer to its slot, rows are never moved. Quad of history is drawn in scene, newest
+/// row on top, values are mapped through colormap in shader
+///
+class Waterfall : protected QOpenGLFunctions
+{
+public:
+
+    // --- Constructors/destructors ---
+
+    ///
+    /// \brief Waterfall - create empty history
+    /// \param width - number of values in row
+    /// \param rows - number of rows kept in history
+    ///
+    Waterfall(size_t width, size_t rows)
+        : m_width{std::max<size_t>(width, 1)}, m_rows{std::clamp<size_t>(rows, 1, WATERFALL_MAX_ROWS)}
+    {
+        m_values.resize(m_width * m_rows);
+    }
+    ~Waterfall() = default;
+
+    Waterfall(const Waterfall &) = delete;
+    Waterfall &operator=(const Waterfall &) = delete;
+
+    // --- Main methods ---
+
+    ///
+    /// \brief addRows - append rows to history, they are uploaded when waterfall is drawn
+    /// \param values - values of rows one after another
+    /// \param count - number of values, incomplete last row is ignored
+    ///
+    void addRows(const float *values, size_t count)
+    {
+        size_t rows = count / m_width;
+        // Rows older than history are overwritten at once
+        if (rows > m_rows) {
+            values += (rows - m_rows) * m_width;
+            m_total += rows - m_rows;
+            rows = m_rows;
+        }
+
+        for (size_t i = 0; i < rows; ++i) {
+            size_t slot = (m_total + i) % m_rows;
+            std::copy(values + i * m_width, values + (i + 1) * m_width, m_values.begin() + slot * m_width);
+        }
+        m_total += rows;
+    }
+
+    ///
+    /// \brief draw - upload new rows and draw history, context must be current
+    /// \param x - X of first value and of value after last
+    /// \param y - Y of oldest row and of row after newest
+    /// \param origin - point of scene from which vertices are given
+    /// \return - false if shader or float texture isn't supported
+    ///
+    bool draw(std::pair<double, double> x, std::pair<double, double> y, std::pair<double, double> origin)
+    {
+        if (!init() || shownRows() == 0)
+            return false;
+
+        upload();
+
+        // Texture coordinate of oldest row, it's wrapped to its slot in shader
+        double oldest = static_cast<double>((m_total - shownRows()) % m_rows) / m_rows;
+        double newest = oldest + static_cast<double>(shownRows()) / m_rows;
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+        m_colormap.bind(1);
+
+        m_program.bind();
+        m_program.setUniformValue("values", 0);
+        m_program.setUniformValue("colormap", 1);
+        m_program.setUniformValue("low", static_cast<GLfloat>(m_levels.first));
+        m_program.setUniformValue("scale", static_cast<GLfloat>(1 / (m_levels.second - m_levels.first)));
+
+        glBegin(GL_QUADS);
+        glTexCoord2d(0, oldest);
+        glVertex2d(x.first - origin.first, y.first - origin.second);
+        glTexCoord2d(1, oldest);
+        glVertex2d(x.second - origin.first, y.first - origin.second);
+        glTexCoord2d(1, newest);
+        glVertex2d(x.second - origin.first, y.second - origin.second);
+        glTexCoord2d(0, newest);
+        glVertex2d(x.first - origin.first, y.second - origin.second);
+        glEnd();
+
+        m_program.release();
+        m_colormap.release(1);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        return true;
+    }
+
+    ///
+    /// \brief destroy - release GPU resources, rows are uploaded again on next draw, context must be current
+    ///
+    void destroy()
+    {
+        if (m_texture)
+            glDeleteTextures(1, &m_texture);
+        m_texture = 0;
+        m_pixelBuffer.destroy();
+        m_colormap.destroy();
+        m_program.removeAllShaders();
+        m_initialized = false;
+        m_uploaded = 0;
+    }
+
+    // --- Setters ---
+
+    ///
+    /// \brief setLevels - set values shown by first and last colors of colormap
+    /// \param levels - lowest and highest values
+    ///
+    void setLevels(std::pair<double, double> levels)
+    {
+        if (levels.second > levels.first)
+            m_levels = levels;
+    }
+
+    ///
+    /// \brief setColormap - set colors of colormap
+    /// \param colors - colors evenly spaced from lowest to highest value, at least two
+    ///
+    void setColormap(const std::vector<QRgb> &colors)
+    {
+        m_colormap.setColors(colors);
+    }
+
+    ///
+    /// \brief setRowStep - set distance between rows along Y, e.g. period of spectra
+    /// \param step - distance in scene measure
+    ///
+    void setRowStep(double step)
+    {
+        if (step > 0)
+            m_rowStep = step;
+    }
+
+    // --- Getters ---
+
+    ///
+    /// \brief width - number of values in row
+    /// \return - number of values
+    ///
+    size_t width() const
+    {
+        return m_width;
+    }
+
+    ///
+    /// \brief rowStep - distance between rows along Y
+    /// \return - distance in scene measure
+    ///
+    double rowStep() const
+    {
+        return m_rowStep;
+    }
+
+    ///
+    /// \brief total - number of rows added since creation
+    /// \return - number of rows
+    ///
+    size_t total() const
+    {
+        return m_total;
+    }
+
+    ///
+    /// \brief shownRows - number of rows in history
+    /// \return - number of rows
+    ///
+    size_t shownRows() const
+    {
+        return std::min(m_total, m_rows);
+    }
+
+    ///
+    /// \brief value - value of history
+    /// \param row - number of row since creation, must be in history
+    /// \param column - index of value in row
+    /// \return - value
+    ///
+    float value(size_t row, size_t column) const
+    {
+        return m_values[(row % m_rows) * m_width + column];
+    }
+
+private:
+
+    // --- Helper methods ---
+
+    ///
+    /// \brief init - create texture, pixel buffer and shader once
+    /// \return - false if they aren't supported
+    ///
+    bool init()
+    {
+        if (m_initialized)
+            return m_supported;
+
+        initializeOpenGLFunctions();
+        m_initialized = true;
+
+        GLint maxSize{};
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+        m_supported = m_width <= static_cast<size_t>(maxSize) && m_rows <= static_cast<size_t>(maxSize)
+                && m_pixelBuffer.create()
+                && m_program.addShaderFromSourceCode(QOpenGLShader::Vertex,
+                                                     "varying vec2 position;\n"
+                                                     "void main() {\n"
+                                                     "    position = gl_MultiTexCoord0.xy;\n"
+                                                     "    gl_Position = ftransform();\n"
+                                                     "}\n")
+                && m_program.addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                                     "uniform sampler2D values;\n"
+                                                     "uniform sampler2D colormap;\n"
+                                                     "uniform float low;\n"
+                                                     "uniform float scale;\n"
+                                                     "varying vec2 position;\n"
+                                                     "void main() {\n"
+                                                     "    float value = texture2D(values, vec2(position.x, fract(position.y))).r;\n"
+                                                     "    float level = clamp((value - low) * scale, 0.0, 1.0);\n"
+                                                     "    gl_FragColor = texture2D(colormap, vec2(level, 0.5));\n"
+                                                     "}\n")
+                && m_program.link();
+        if (!m_supported)
+            return false;
+
+        // Rows are sampled exactly, wrap of ring isn't blended with oldest row
+        glGenTextures(1, &m_texture);
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, m_width, m_rows, 0, GL_RED, GL_FLOAT, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        m_pixelBuffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+        m_uploaded = 0;
+
+        return true;
+    }
+
+    ///
+    /// \brief upload - upload rows added since last draw through pixel buffer, only their slots are written
+    ///
+    void upload()
+    {
+        size_t first = std::max(m_uploaded, m_total - shownRows());
+        size_t count = m_total - first;
+        if (count == 0)
+            return;
+
+        size_t rowBytes = m_width * sizeof(float);
+        size_t slot = first % m_rows;
+        size_t head = std::min(count, m_rows - slot);
+
+        // Buffer is orphaned, so upload doesn't wait for transfer of previous frame
+        m_pixelBuffer.bind();
+        m_pixelBuffer.allocate(static_cast<int>(count * rowBytes));
+        m_pixelBuffer.write(0, m_values.data() + slot * m_width, static_cast<int>(head * rowBytes));
+        if (count > head)
+            m_pixelBuffer.write(static_cast<int>(head * rowBytes), m_values.data(),
+                                static_cast<int>((count - head) * rowBytes));
+
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, slot, m_width, head, GL_RED, GL_FLOAT, nullptr);
+        if (count > head)
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, count - head, GL_RED, GL_FLOAT,
+                            reinterpret_cast<const void *>(head * rowBytes));
+        glBindTexture(GL_TEXTURE_2D, 0);
+        m_pixelBuffer.release();
+
+        m_uploaded = m_total;
+    }
+
+    // --- Fields ---
+
+    size_t                                m_width; ///< Number of values in row
+    size_t                                 m_rows; ///< Number of rows in history
+    size_t                             m_total{0}; ///< Number of rows added since creation
+    size_t                          m_uploaded{0}; ///< Number of rows uploaded to texture
+    std::vector<float>                   m_values; ///< Ring of rows, row is in slot of its number modulo rows
+    std::pair<double, double>      m_levels{0, 1}; ///< Values shown by first and last colors
+    double                           m_rowStep{1}; ///< Distance between rows along Y
+
+    GLuint                            m_texture{0}; ///< Ring texture of rows
+    QOpenGLBuffer m_pixelBuffer{QOpenGLBuffer::PixelUnpackBuffer}; ///< Transfers new rows to texture
+    QOpenGLShaderProgram                m_program; ///< Maps values through colormap
+    Colormap                           m_colormap; ///< Colors of values
+    bool                      m_initialized{false}; ///< Whether GPU resources are created
+    bool                        m_supported{false}; ///< Whether waterfall can be drawn
+};
+
+#endif // WATERFALL_H
@@ -1,6 +1,8 @@
 #ifndef WIDGET_SIGNALS_H
 #define WIDGET_SIGNALS_H
 
+#include "trace_recorder.h"
+
 #include <QObject>
 
 ///
@@ -19,6 +21,7 @@ public:
     ///
     void triggerSignalTextValues(int id)
     {
+        TRACE_SPAN("signal updateTextValues");
         emit updateTextValues(id);
     }
 
@@ -28,9 +31,80 @@ public:
     ///
     void triggerSignalCurrentTab(int id)
     {
+        TRACE_SPAN("signal updateCurrentTab");
         emit updateCurrentTab(id);
     }
 
+    ///
+    /// \brief triggerSignalFrameStatistics - called in OpenGLWidget class, emit signal
+    /// \param id - id of OpenGLWidget class
+    ///
+    void triggerSignalFrameStatistics(int id)
+    {
+        TRACE_SPAN("signal updateFrameStatistics");
+        emit updateFrameStatistics(id);
+    }
+
+    ///
+    /// \brief triggerSignalFrameBudget - called in OpenGLWidget class, emit signal
+    /// \param id - id of OpenGLWidget class
+    ///
+    void triggerSignalFrameBudget(int id)
+    {
+        TRACE_SPAN("signal frameBudgetExceeded");
+        emit frameBudgetExceeded(id);
+    }
+
+    ///
+    /// \brief triggerSignalRefinementFinished - called in OpenGLWidget class, emit signal
+    /// \param id - id of OpenGLWidget class
+    ///
+    void triggerSignalRefinementFinished(int id)
+    {
+        TRACE_SPAN("signal refinementFinished");
+        emit refinementFinished(id);
+    }
+
+    ///
+    /// \brief triggerSignalQualityChanged - called in OpenGLWidget class, emit signal
+    /// \param id - id of OpenGLWidget class
+    ///
+    void triggerSignalQualityChanged(int id)
+    {
+        TRACE_SPAN("signal qualityChanged");
+        emit qualityChanged(id);
+    }
+
+    ///
+    /// \brief triggerSignalRangeStatistics - called in OpenGLWidget class, emit signal
+    /// \param id - id of OpenGLWidget class
+    ///
+    void triggerSignalRangeStatistics(int id)
+    {
+        TRACE_SPAN("signal rangeStatisticsUpdated");
+        emit rangeStatisticsUpdated(id);
+    }
+
+    ///
+    /// \brief triggerSignalGraphPicked - called in OpenGLWidget class, emit signal
+    /// \param id - id of OpenGLWidget class
+    ///
+    void triggerSignalGraphPicked(int id)
+    {
+        TRACE_SPAN("signal graphPicked");
+        emit graphPicked(id);
+    }
+
+    ///
+    /// \brief triggerSignalGraphHovered - called in OpenGLWidget class, emit signal
+    /// \param id - id of OpenGLWidget class
+    ///
+    void triggerSignalGraphHovered(int id)
+    {
+        TRACE_SPAN("signal graphHovered");
+        emit graphHovered(id);
+    }
+
 signals:
 
     ///
@@ -44,6 +118,49 @@ signals:
     /// \param id - id of current tab
     ///
     void updateCurrentTab(int id);
+
+    ///
+    /// \brief updateFrameStatistics - signal, what external class accept, statistics of frame timing are updated
+    /// \param id - id of OpenGLWidget class
+    ///
+    void updateFrameStatistics(int id);
+
+    ///
+    /// \brief frameBudgetExceeded - signal, what external class accept, p95 frame time is over budget
+    /// \param id - id of OpenGLWidget class
+    ///
+    void frameBudgetExceeded(int id);
+
+    ///
+    /// \brief refinementFinished - signal, what external class accept, all graphs are drawn at needed level of detail
+    /// \param id - id of OpenGLWidget class
+    ///
+    void refinementFinished(int id);
+
+    ///
+    /// \brief qualityChanged - signal, what external class accept, quality governor changed quality level
+    /// \param id - id of OpenGLWidget class
+    ///
+    void qualityChanged(int id);
+
+    ///
+    /// \brief rangeStatisticsUpdated - signal, what external class accept, statistics of graphs in measured range
+    /// are counted
+    /// \param id - id of OpenGLWidget class
+    ///
+    void rangeStatisticsUpdated(int id);
+
+    ///
+    /// \brief graphPicked - signal, what external class accept, graph under cursor is picked by click
+    /// \param id - id of OpenGLWidget class
+    ///
+    void graphPicked(int id);
+
+    ///
+    /// \brief graphHovered - signal, what external class accept, graph under moving cursor is changed
+    /// \param id - id of OpenGLWidget class
+    ///
+    void graphHovered(int id);
 };
 
 #endif // WIDGET_SIGNALS_H